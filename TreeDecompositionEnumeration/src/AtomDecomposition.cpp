@@ -0,0 +1,153 @@
+#include "AtomDecomposition.h"
+#include "MinimalTriangulator.h"
+#include "PMCEnumerator.h"
+#include <omp.h>
+
+namespace tdenum {
+
+static bool isClique(const Graph& g, const NodeSet& s) {
+	for (unsigned int i=0; i<s.size(); i++) {
+		for (unsigned int j=i+1; j<s.size(); j++) {
+			if (!g.areNeighbors(s[i], s[j])) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+ * Initialization. The connected components are split first, and then every
+ * minimal separator of an MCS-M triangulation that is a clique in the graph
+ * splits the atoms containing it.
+ */
+AtomDecomposition::AtomDecomposition(GraphPtr g, CancellationTokenPtr cancellation) :
+		graph(g) {
+	atoms = graph->getComponents(NodeSet());
+	for (unsigned int i=0; i<atoms.size(); i++) {
+		sort(atoms[i].begin(), atoms[i].end());
+	}
+	OverlayGraph overlay(*graph);
+	MinimalTriangulator triangulator(MCS_M);
+	set<MinimalSeparator> separators = triangulator.triangulateToMinimalSeparators(overlay);
+	for (set<MinimalSeparator>::iterator it = separators.begin(); it != separators.end(); ++it) {
+		if (cancellation && cancellation->isCancelled()) {
+			break;
+		}
+		if (isClique(*graph, *it)) {
+			cliqueSeparators.insert(*it);
+			split(*it);
+		}
+	}
+	sort(atoms.begin(), atoms.end());
+}
+
+/*
+ * An atom A containing s is split if s is a minimal separator of the subgraph
+ * induced by A, that is, if it has two full components there. Every component
+ * C then gives the atom C and its neighbors in A.
+ */
+void AtomDecomposition::split(const MinimalSeparator& s) {
+	vector<NodeSet> splitAtoms;
+	for (unsigned int i=0; i<atoms.size(); i++) {
+		const NodeSet& atom = atoms[i];
+		if (!includes(atom.begin(), atom.end(), s.begin(), s.end())) {
+			splitAtoms.push_back(atom);
+			continue;
+		}
+		// Remove s and the nodes out of the atom
+		vector<bool> kept(graph->getNumberOfNodes(), false);
+		for (unsigned int j=0; j<atom.size(); j++) {
+			kept[atom[j]] = true;
+		}
+		for (unsigned int j=0; j<s.size(); j++) {
+			kept[s[j]] = false;
+		}
+		NodeSet removed;
+		for (Node v=0; v<graph->getNumberOfNodes(); v++) {
+			if (!kept[v]) {
+				removed.push_back(v);
+			}
+		}
+		vector<NodeSet> components = graph->getComponents(removed);
+		vector<NodeSet> pieces;
+		int fullComponents = 0;
+		for (unsigned int j=0; j<components.size(); j++) {
+			sort(components[j].begin(), components[j].end());
+			NodeSet neighbors = graph->getNeighbors(components[j]);
+			NodeSet neighborsInAtom;
+			set_intersection(neighbors.begin(), neighbors.end(), atom.begin(), atom.end(),
+					back_inserter(neighborsInAtom));
+			if (neighborsInAtom.size() == s.size()) {
+				fullComponents++;
+			}
+			NodeSet piece;
+			set_union(components[j].begin(), components[j].end(),
+					neighborsInAtom.begin(), neighborsInAtom.end(), back_inserter(piece));
+			pieces.push_back(piece);
+		}
+		if (fullComponents < 2) {
+			splitAtoms.push_back(atom);
+		} else {
+			splitAtoms.insert(splitAtoms.end(), pieces.begin(), pieces.end());
+		}
+	}
+	atoms = splitAtoms;
+}
+
+int AtomDecomposition::getNumberOfAtoms() const {
+	return atoms.size();
+}
+
+const NodeSet& AtomDecomposition::getAtom(int i) const {
+	return atoms[i];
+}
+
+Graph AtomDecomposition::getAtomGraph(int i) const {
+	const NodeSet& atom = atoms[i];
+	vector<int> position(graph->getNumberOfNodes(), -1);
+	for (unsigned int j=0; j<atom.size(); j++) {
+		position[atom[j]] = j;
+	}
+	Graph atomGraph(atom.size());
+	for (unsigned int j=0; j<atom.size(); j++) {
+		const set<Node>& neighbors = graph->getNeighbors(atom[j]);
+		for (set<Node>::const_iterator it = neighbors.begin(); it != neighbors.end(); ++it) {
+			if (position[*it] > (int)j) {
+				atomGraph.addEdge(j, position[*it]);
+			}
+		}
+	}
+	return atomGraph;
+}
+
+const set<MinimalSeparator>& AtomDecomposition::getCliqueMinimalSeparators() const {
+	return cliqueSeparators;
+}
+
+NodeSetSet getPotentialMaximalCliquesByAtoms(GraphPtr g, PMCAlg alg,
+		CancellationTokenPtr cancellation) {
+	AtomDecomposition decomposition(g, cancellation);
+	vector<NodeSetSet> atomsPMCs(decomposition.getNumberOfAtoms());
+	#pragma omp parallel for schedule(dynamic)
+	for (int i=0; i<decomposition.getNumberOfAtoms(); i++) {
+		PMCEnumerator pmce(decomposition.getAtomGraph(i));
+		pmce.set_algorithm(alg);
+		pmce.set_cancellation_token(cancellation);
+		atomsPMCs[i] = pmce.get();
+	}
+	NodeSetSet pmcs;
+	for (int i=0; i<decomposition.getNumberOfAtoms(); i++) {
+		const NodeSet& atom = decomposition.getAtom(i);
+		for (NodeSetSet::iterator it = atomsPMCs[i].begin(); it != atomsPMCs[i].end(); ++it) {
+			NodeSet pmc;
+			for (unsigned int j=0; j<it->size(); j++) {
+				pmc.push_back(atom[(*it)[j]]);
+			}
+			pmcs.insert(pmc);
+		}
+	}
+	return pmcs;
+}
+
+} /* namespace tdenum */
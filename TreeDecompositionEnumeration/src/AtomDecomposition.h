@@ -0,0 +1,55 @@
+#ifndef ATOMDECOMPOSITION_H_
+#define ATOMDECOMPOSITION_H_
+
+#include "Graph.h"
+#include "PMCAlg.h"
+#include "CancellationToken.h"
+
+namespace tdenum {
+
+/**
+ * Decomposes a graph by its clique minimal separators into atoms, which are
+ * the maximal connected node sets without a clique separator.
+ *
+ * The clique minimal separators of a graph are minimal separators of each of
+ * its minimal triangulations, so they are found among the minimal separators
+ * of one triangulation by MCS-M. The graph is then split by each of them in
+ * turn. See:
+ * A. Berry, R. Pogorelcnik and G. Simonet. An introduction to clique minimal
+ * separator decomposition, 2010.
+ *
+ * Every minimal triangulation of the graph is the union of one minimal
+ * triangulation of every atom, its width is the largest width and its fill is
+ * the sum of the fills. The potential maximal cliques of the graph are the
+ * ones of its atoms.
+ *
+ * If the token is cancelled, splitting stops. The atoms found so far are still
+ * a decomposition by clique minimal separators, only a coarser one.
+ */
+class AtomDecomposition {
+	GraphPtr graph;
+	set<MinimalSeparator> cliqueSeparators;
+	vector<NodeSet> atoms; // Sorted
+	// Splits the atoms containing the separator, if it separates them
+	void split(const MinimalSeparator& s);
+public:
+	AtomDecomposition(GraphPtr g, CancellationTokenPtr cancellation = CancellationTokenPtr());
+	// Returns the number of atoms
+	int getNumberOfAtoms() const;
+	// Returns the nodes of the atom
+	const NodeSet& getAtom(int i) const;
+	// Returns the subgraph induced by the atom, in which every node is named
+	// by its position in the atom
+	Graph getAtomGraph(int i) const;
+	// Returns the clique minimal separators of the graph
+	const set<MinimalSeparator>& getCliqueMinimalSeparators() const;
+};
+
+// Returns the potential maximal cliques of the graph, enumerated on its atoms
+// in parallel by the given algorithm, until the token is cancelled
+NodeSetSet getPotentialMaximalCliquesByAtoms(GraphPtr g, PMCAlg alg,
+		CancellationTokenPtr cancellation = CancellationTokenPtr());
+
+} /* namespace tdenum */
+
+#endif /* ATOMDECOMPOSITION_H_ */
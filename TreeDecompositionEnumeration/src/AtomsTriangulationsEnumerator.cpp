@@ -0,0 +1,232 @@
+#include "AtomsTriangulationsEnumerator.h"
+#include <omp.h>
+
+namespace tdenum {
+
+/*
+ * Initialization. A graph without nodes has no atoms, and the empty
+ * combination is its only triangulation.
+ */
+AtomsTriangulationsEnumerator::AtomsTriangulationsEnumerator(
+			Graph g, TriangulationScoringCriterion triC,
+			SeparatorsScoringCriterion sepC, TriangulationAlgorithm heuristic,
+			CancellationTokenPtr cancellation) :
+		graph(make_shared<const Graph>(move(g))), decomposition(graph, cancellation),
+		resultsProduced(0), fixedAtom(-1) {
+	int atoms = decomposition.getNumberOfAtoms();
+	atomEnumerators.resize(atoms, NULL);
+	#pragma omp parallel for schedule(dynamic)
+	for (int i=0; i<atoms; i++) {
+		atomEnumerators[i] = new MinimalTriangulationsEnumerator(
+				decomposition.getAtomGraph(i), triC, sepC, heuristic);
+		atomEnumerators[i]->setCancellationToken(cancellation);
+	}
+	atomDone.resize(atoms, false);
+	atomResults.resize(atoms);
+	combination.resize(atoms, 0);
+	combinationBounds.resize(atoms, 0);
+	hasCombination = atoms == 0;
+}
+
+AtomsTriangulationsEnumerator::~AtomsTriangulationsEnumerator() {
+	for (unsigned int i=0; i<atomEnumerators.size(); i++) {
+		delete atomEnumerators[i];
+	}
+}
+
+void AtomsTriangulationsEnumerator::runRound() {
+	int atoms = atomEnumerators.size();
+	vector< vector<AtomResult> > produced(atoms);
+	#pragma omp parallel for schedule(dynamic)
+	for (int i=0; i<atoms; i++) {
+		if (atomDone[i]) {
+			continue;
+		}
+		const NodeSet& atom = decomposition.getAtom(i);
+		while ((int)produced[i].size() < ATOM_RESULTS_PER_ROUND && atomEnumerators[i]->hasNext()) {
+			TriangulationHandle handle = atomEnumerators[i]->nextHandle();
+			AtomResult result;
+			const vector< pair<Node,Node> >& fillEdges = handle.getFillEdges();
+			for (unsigned int j=0; j<fillEdges.size(); j++) {
+				result.fillEdges.push_back(make_pair(atom[fillEdges[j].first],
+						atom[fillEdges[j].second]));
+			}
+			result.width = handle.getTreeWidth();
+			produced[i].push_back(result);
+		}
+	}
+	for (int i=0; i<atoms; i++) {
+		if (atomDone[i]) {
+			continue;
+		}
+		for (unsigned int j=0; j<produced[i].size(); j++) {
+			produced[i][j].produced = resultsProduced++;
+			resultsToCombine.push_back(make_pair(i, atomResults[i].size()));
+			atomResults[i].push_back(produced[i][j]);
+		}
+		atomDone[i] = (int)produced[i].size() < ATOM_RESULTS_PER_ROUND;
+	}
+}
+
+/*
+ * The result is combined with the results of the other atoms that were
+ * produced before it. If one of them has none, there is nothing to return.
+ */
+bool AtomsTriangulationsEnumerator::startCombining() {
+	if (resultsToCombine.empty()) {
+		return false;
+	}
+	fixedAtom = resultsToCombine.front().first;
+	int index = resultsToCombine.front().second;
+	resultsToCombine.pop_front();
+	long long producedAt = atomResults[fixedAtom][index].produced;
+	hasCombination = true;
+	for (unsigned int i=0; i<atomResults.size(); i++) {
+		if ((int)i == fixedAtom) {
+			combination[i] = index;
+			continue;
+		}
+		int bound = 0;
+		while (bound < (int)atomResults[i].size() && atomResults[i][bound].produced < producedAt) {
+			bound++;
+		}
+		combination[i] = 0;
+		combinationBounds[i] = bound;
+		hasCombination = hasCombination && bound > 0;
+	}
+	return true;
+}
+
+bool AtomsTriangulationsEnumerator::nextCombination() {
+	for (int i=atomResults.size()-1; i>=0; i--) {
+		if (i == fixedAtom) {
+			continue;
+		}
+		combination[i]++;
+		if (combination[i] < combinationBounds[i]) {
+			return true;
+		}
+		combination[i] = 0;
+	}
+	return false;
+}
+
+/*
+ * Checks whether there is another minimal triangulation
+ */
+bool AtomsTriangulationsEnumerator::hasNext() {
+	while (!hasCombination) {
+		if (startCombining()) {
+			continue;
+		}
+		bool allDone = true;
+		for (unsigned int i=0; i<atomDone.size(); i++) {
+			allDone = allDone && atomDone[i];
+		}
+		if (allDone) {
+			return false;
+		}
+		runRound();
+	}
+	return true;
+}
+
+void AtomsTriangulationsEnumerator::advance() {
+	if (!hasNext()) {
+		return;
+	}
+	current = combination;
+	hasCombination = nextCombination();
+}
+
+int AtomsTriangulationsEnumerator::getTreeWidth() const {
+	int width = 0;
+	for (unsigned int i=0; i<current.size(); i++) {
+		width = max(width, atomResults[i][current[i]].width);
+	}
+	return width;
+}
+
+int AtomsTriangulationsEnumerator::getFillIn() const {
+	int fill = 0;
+	for (unsigned int i=0; i<current.size(); i++) {
+		fill += atomResults[i][current[i]].fillEdges.size();
+	}
+	return fill;
+}
+
+ChordalGraph AtomsTriangulationsEnumerator::getTriangulation() const {
+	ChordalGraph triangulation(*graph);
+	for (unsigned int i=0; i<current.size(); i++) {
+		const vector< pair<Node,Node> >& fillEdges = atomResults[i][current[i]].fillEdges;
+		for (unsigned int j=0; j<fillEdges.size(); j++) {
+			triangulation.addEdge(fillEdges[j].first, fillEdges[j].second);
+		}
+	}
+	return triangulation;
+}
+
+/*
+ * Returns another minimal triangulation
+ */
+ChordalGraph AtomsTriangulationsEnumerator::next() {
+	if (!hasNext()) {
+		return ChordalGraph();
+	}
+	advance();
+	return getTriangulation();
+}
+
+void AtomsTriangulationsEnumerator::setCancellationToken(CancellationTokenPtr token) {
+	for (unsigned int i=0; i<atomEnumerators.size(); i++) {
+		atomEnumerators[i]->setCancellationToken(token);
+	}
+}
+
+int AtomsTriangulationsEnumerator::getNumberOfAtoms() {
+	return decomposition.getNumberOfAtoms();
+}
+
+long long AtomsTriangulationsEnumerator::getNumberOfTriangulations() {
+	bool allDone = false;
+	while (!allDone) {
+		allDone = true;
+		for (unsigned int i=0; i<atomDone.size(); i++) {
+			allDone = allDone && atomDone[i];
+		}
+		if (!allDone) {
+			runRound();
+		}
+	}
+	long long triangulations = 1;
+	for (unsigned int i=0; i<atomResults.size(); i++) {
+		triangulations *= atomResults[i].size();
+	}
+	return triangulations;
+}
+
+int AtomsTriangulationsEnumerator::getNumberOfMinimalSeperatorsGenerated() {
+	int separators = 0;
+	for (unsigned int i=0; i<atomEnumerators.size(); i++) {
+		separators += atomEnumerators[i]->getNumberOfMinimalSeperatorsGenerated();
+	}
+	return separators;
+}
+
+long long AtomsTriangulationsEnumerator::getNumberOfExtensionsReused() {
+	long long reused = 0;
+	for (unsigned int i=0; i<atomEnumerators.size(); i++) {
+		reused += atomEnumerators[i]->getNumberOfExtensionsReused();
+	}
+	return reused;
+}
+
+long long AtomsTriangulationsEnumerator::getNumberOfExtensionsComputed() {
+	long long computed = 0;
+	for (unsigned int i=0; i<atomEnumerators.size(); i++) {
+		computed += atomEnumerators[i]->getNumberOfExtensionsComputed();
+	}
+	return computed;
+}
+
+} /* namespace tdenum */
@@ -0,0 +1,90 @@
+#ifndef ATOMSTRIANGULATIONSENUMERATOR_H_
+#define ATOMSTRIANGULATIONSENUMERATOR_H_
+
+#include "AtomDecomposition.h"
+#include "MinimalTriangulationsEnumerator.h"
+#include <deque>
+
+namespace tdenum {
+
+// How many triangulations each atom produces per round
+#define ATOM_RESULTS_PER_ROUND 8
+
+/**
+ * Enumerates the minimal triangulations of a graph as the products of the
+ * minimal triangulations of its atoms (see AtomDecomposition).
+ *
+ * Every atom is enumerated by its own MinimalTriangulationsEnumerator, and each
+ * round the atoms still running produce a few results in parallel. The product
+ * is streamed without being materialized: when an atom produces a result, it is
+ * combined with the results the other atoms produced before it, so every
+ * combination is returned once, as soon as all of its parts are known. The
+ * width and fill of a combination are computed from its parts, and the
+ * triangulation is only built when asked for.
+ */
+class AtomsTriangulationsEnumerator {
+	// A minimal triangulation of an atom, in the node names of the graph
+	struct AtomResult {
+		vector< pair<Node,Node> > fillEdges;
+		int width;
+		long long produced; // When it was produced, over all atoms
+	};
+	GraphPtr graph;
+	AtomDecomposition decomposition;
+	vector<MinimalTriangulationsEnumerator*> atomEnumerators;
+	vector<bool> atomDone;
+	vector< vector<AtomResult> > atomResults;
+	long long resultsProduced;
+	// Results whose combinations were not returned yet, as (atom, index)
+	deque< pair<int,int> > resultsToCombine;
+	// The combinations of the result being combined are counted by an odometer
+	// over the results of the other atoms produced before it
+	int fixedAtom;
+	vector<int> combinationBounds;
+	vector<int> combination;
+	bool hasCombination;
+	vector<int> current; // The combination returned last
+	// Lets every running atom produce more results
+	void runRound();
+	// Starts combining the next result, returns false if there is none
+	bool startCombining();
+	// Moves the odometer, returns false when it wraps around
+	bool nextCombination();
+	// The atoms are owned, so copying is not allowed
+	AtomsTriangulationsEnumerator(const AtomsTriangulationsEnumerator&);
+	AtomsTriangulationsEnumerator& operator=(const AtomsTriangulationsEnumerator&);
+public:
+	// initialization. The token, if given, also stops the decomposition.
+	AtomsTriangulationsEnumerator(Graph g, TriangulationScoringCriterion triC,
+			SeparatorsScoringCriterion sepC, TriangulationAlgorithm heuristic,
+			CancellationTokenPtr cancellation = CancellationTokenPtr());
+	~AtomsTriangulationsEnumerator();
+	// Checks whether there is another minimal triangulation
+	bool hasNext();
+	// Moves to another minimal triangulation, without building it
+	void advance();
+	// Returns the width and the number of fill edges of the current triangulation
+	int getTreeWidth() const;
+	int getFillIn() const;
+	// Builds the current triangulation
+	ChordalGraph getTriangulation() const;
+	// Returns another minimal triangulation
+	ChordalGraph next();
+	// Stops the enumeration of every atom once the token is cancelled
+	void setCancellationToken(CancellationTokenPtr token);
+	// Returns the number of atoms the graph was decomposed into
+	int getNumberOfAtoms();
+	// Returns the number of minimal triangulations of the graph, which is the
+	// product of the numbers of the atoms. Enumerates all the atoms.
+	long long getNumberOfTriangulations();
+	// Returns the number of minimal separators generated, summed over the atoms
+	int getNumberOfMinimalSeperatorsGenerated();
+	// Returns how many set extensions were reused, and how many were computed,
+	// summed over the atoms
+	long long getNumberOfExtensionsReused();
+	long long getNumberOfExtensionsComputed();
+};
+
+} /* namespace tdenum */
+
+#endif /* ATOMSTRIANGULATIONSENUMERATOR_H_ */
@@ -0,0 +1,75 @@
+#include "CancellationToken.h"
+#include <csignal>
+
+namespace tdenum {
+
+// The token cancelled by signals. Storing a flag through a lock-free atomic is
+// safe in a signal handler.
+static atomic<CancellationToken*> signalledToken(NULL);
+
+static void cancelSignalledToken(int) {
+	CancellationToken* token = signalledToken.load();
+	if (token != NULL) {
+		token->cancel();
+	}
+}
+
+CancellationToken::CancellationToken() :
+		cancelled(false), start(chrono::steady_clock::now()), hasDeadline(false) {}
+
+CancellationToken::CancellationToken(shared_ptr<const CancellationToken> parent) :
+		cancelled(false), parent(parent), start(chrono::steady_clock::now()),
+		hasDeadline(false) {}
+
+void CancellationToken::setTimeLimit(double seconds) {
+	hasDeadline = true;
+	deadline = start + chrono::duration_cast<chrono::steady_clock::duration>(
+			chrono::duration<double>(seconds));
+}
+
+void CancellationToken::unsetTimeLimit() {
+	hasDeadline = false;
+}
+
+void CancellationToken::cancel() {
+	cancelled.store(true);
+}
+
+bool CancellationToken::isCancelled() const {
+	if (cancelled.load(memory_order_relaxed)) {
+		return true;
+	}
+	if ((hasDeadline && chrono::steady_clock::now() >= deadline)
+			|| (parent && parent->isCancelled())) {
+		cancelled.store(true, memory_order_relaxed);
+		return true;
+	}
+	return false;
+}
+
+/*
+ * The count is per thread, so polling from many threads does not contend on
+ * a shared counter.
+ */
+bool CancellationToken::poll() const {
+	if (cancelled.load(memory_order_relaxed)) {
+		return true;
+	}
+	static thread_local unsigned int calls = 0;
+	if (++calls < CANCELLATION_POLL_INTERVAL) {
+		return false;
+	}
+	calls = 0;
+	return isCancelled();
+}
+
+double CancellationToken::getElapsedSeconds() const {
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void CancellationToken::cancelOnSignal(int signal) {
+	signalledToken.store(this);
+	std::signal(signal, cancelSignalledToken);
+}
+
+} /* namespace tdenum */
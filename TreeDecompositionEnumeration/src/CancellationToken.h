@@ -0,0 +1,62 @@
+#ifndef CANCELLATIONTOKEN_H_
+#define CANCELLATIONTOKEN_H_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+using namespace std;
+
+namespace tdenum {
+
+// How many calls to poll() in a thread read the clock once
+#define CANCELLATION_POLL_INTERVAL 1024
+
+/**
+ * Tells the engines of a computation when to stop. It is cancelled by
+ * cancel(), which may be called from another thread or from a signal handler,
+ * once its time limit passes, or once the token it was derived from is
+ * cancelled. Time is measured on the monotonic steady_clock, so limits may be
+ * fractions of a second and are not affected by the number of threads.
+ *
+ * Engines check the token in their loops. isCancelled() reads the clock, and
+ * poll() only reads it once every CANCELLATION_POLL_INTERVAL calls in the
+ * calling thread, so hot loops mostly read an atomic flag. A cancelled token
+ * stays cancelled.
+ */
+class CancellationToken {
+	mutable atomic<bool> cancelled;
+	shared_ptr<const CancellationToken> parent;
+	chrono::steady_clock::time_point start;
+	bool hasDeadline;
+	chrono::steady_clock::time_point deadline;
+	CancellationToken(const CancellationToken&);
+	CancellationToken& operator=(const CancellationToken&);
+public:
+	// Initialization. The time limit counts from here.
+	CancellationToken();
+	// Also cancelled whenever the parent is, if there is one
+	explicit CancellationToken(shared_ptr<const CancellationToken> parent);
+	// Cancels the token the given number of seconds after it was created.
+	// Must not be called while other threads check the token.
+	void setTimeLimit(double seconds);
+	void unsetTimeLimit();
+	// Cancels the token
+	void cancel();
+	// Checks whether the token is cancelled
+	bool isCancelled() const;
+	// Same, reading the clock only once in a while
+	bool poll() const;
+	// Returns the number of seconds since the token was created
+	double getElapsedSeconds() const;
+	// Cancels the token when the process receives the given signal (for
+	// example SIGTERM). Only one token is cancelled by signals, the last one
+	// this is called on, and it must outlive the handler.
+	void cancelOnSignal(int signal);
+};
+
+typedef shared_ptr<CancellationToken> CancellationTokenPtr;
+
+} /* namespace tdenum */
+
+#endif /* CANCELLATIONTOKEN_H_ */
@@ -28,12 +28,57 @@ ChordalGraph::~ChordalGraph() {}
  * Uses a Maximum Cardinality Search priority queue, where the weight of a node
  * is the number of neighbors it has that were already visited. If this weight
  * is smaller or equal to the previous weight, it with its neighbors form a
- * clique.
+ * clique. At the same points the visited neighbors of the current node form a
+ * minimal separator, as described in:
+ * P. Kumar and C. Madhavan. Minimal vertex separators of chordal graphs.
+ * Discrete Applied Mathematics, 89(1-3): 155-168, 1998.
  */
 set<NodeSet> ChordalGraph::getMaximalCliques() const {
+	CliqueTree tree;
+	searchCliqueTree(tree, true, false);
+	return move(tree.maximalCliques);
+}
+
+/*
+ * Collects the cliques and separators in the same search, so that reporting a
+ * result costs one pass instead of one per measure.
+ */
+CliqueTree ChordalGraph::getCliqueTree(const Graph& origin) const {
+	CliqueTree tree;
+	searchCliqueTree(tree, true, true);
+	tree.fill = getFillIn(origin);
+	return tree;
+}
+
+/*
+ * Every maximal clique is met once by the search, so the measures are summed
+ * as the cliques are found and no set is built.
+ */
+CliqueTree ChordalGraph::getCliqueTreeMeasures(const Graph& origin) const {
+	CliqueTree tree;
+	searchCliqueTree(tree, false, false);
+	tree.fill = getFillIn(origin);
+	return tree;
+}
+
+/*
+ * Adds a maximal clique to the width and exponential bags size of the tree,
+ * and keeps it if asked to.
+ */
+static void addMaximalClique(CliqueTree& tree, NodeSet& clique, bool keepCliques) {
+	if (tree.width < (int)clique.size() - 1) {
+		tree.width = clique.size() - 1;
+	}
+	tree.expBagsSize += pow((double)2,(double)clique.size());
+	if (keepCliques) {
+		tree.maximalCliques.insert(move(clique));
+	}
+}
+
+void ChordalGraph::searchCliqueTree(CliqueTree& tree, bool keepCliques,
+		bool keepSeparators) const {
 	// initialize structures
-	set<NodeSet> cliques; // holds the result
-	map<Node, bool> isVisited; // default is false
+	vector<bool> isVisited(getNumberOfNodes(), false);
 	IncreasingWeightNodeQueue queue(getNumberOfNodes());
 	int previousNumberOfNeighbors = -1;
 	Node previousNode = -1;
@@ -44,16 +89,30 @@ set<NodeSet> ChordalGraph::getMaximalCliques() const {
 		int currentNumberOfNeighbors = queue.getWeight(currentNode);
 		// Add a new clique if relevant
 		if (currentNumberOfNeighbors <= previousNumberOfNeighbors) {
-			// add currentNode and  its visited neighbors to cliques
-			NodeSetProducer cliqueProducer(getNumberOfNodes());
-			cliqueProducer.insert(previousNode);
+			// add currentNode and  its visited neighbors to cliques.
+			// The neighbors are iterated in ascending order, so the clique is
+			// sorted once previousNode is put in place.
+			NodeSet clique;
 			for (set<Node>::iterator i = getNeighbors(previousNode).begin();
 					i!=getNeighbors(previousNode).end(); ++i) {
 				if (isVisited[*i]) {
-					cliqueProducer.insert(*i);
+					clique.push_back(*i);
+				}
+			}
+			clique.insert(lower_bound(clique.begin(), clique.end(), previousNode), previousNode);
+			addMaximalClique(tree, clique, keepCliques);
+			if (keepSeparators) {
+				MinimalSeparator separator;
+				for (set<Node>::iterator i = getNeighbors(currentNode).begin();
+						i!=getNeighbors(currentNode).end(); ++i) {
+					if (isVisited[*i]) {
+						separator.push_back(*i);
+					}
+				}
+				if (!separator.empty()) {
+					tree.minimalSeparators.insert(separator);
 				}
 			}
-			cliques.insert(cliqueProducer.produce());
 		}
 		// Update structures
 		for (set<Node>::iterator i = getNeighbors(currentNode).begin();
@@ -67,14 +126,9 @@ set<NodeSet> ChordalGraph::getMaximalCliques() const {
 		previousNode = currentNode;
 	}
 	// add the last clique
-	NodeSetProducer cliqueProducer(getNumberOfNodes());
-	cliqueProducer.insert(previousNode);
-	for (set<Node>::iterator i = getNeighbors(previousNode).begin();
-			i!=getNeighbors(previousNode).end(); ++i) {
-		cliqueProducer.insert(*i);
-	}
-	cliques.insert(cliqueProducer.produce());
-	return cliques;
+	NodeSet clique(getNeighbors(previousNode).begin(), getNeighbors(previousNode).end());
+	clique.insert(lower_bound(clique.begin(), clique.end(), previousNode), previousNode);
+	addMaximalClique(tree, clique, keepCliques);
 }
 
 vector< set<Node> > ChordalGraph::getFillEdges(const Graph& origin) const {
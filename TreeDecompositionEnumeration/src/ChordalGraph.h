@@ -14,6 +14,20 @@
 
 namespace tdenum {
 
+/*
+ * The by-products of a single Maximum Cardinality Search over a chordal graph:
+ * its maximal cliques and minimal separators, and the measures derived from
+ * them.
+ */
+struct CliqueTree {
+	set<NodeSet> maximalCliques;
+	set<MinimalSeparator> minimalSeparators;
+	int width; // size of the largest maximal clique minus one
+	int fill; // number of fill edges with respect to the origin graph
+	long long expBagsSize; // Sum_{MaximalCliques b}2^|b|
+	CliqueTree() : width(-1), fill(0), expBagsSize(0) {}
+};
+
 class ChordalGraph: public Graph {
 public:
 	ChordalGraph();
@@ -22,6 +36,11 @@ public:
 	virtual ~ChordalGraph();
 	// Returns the maximal cliques of the graph
 	set<NodeSet> getMaximalCliques() const;
+	// If this is a triangulation of origin, returns its maximal cliques,
+	// minimal separators, width, fill and exponential bags size at once
+	CliqueTree getCliqueTree(const Graph& origin) const;
+	// Same, but only the width, fill and exponential bags size are set
+	CliqueTree getCliqueTreeMeasures(const Graph& origin) const;
 	// Returns the edges in this graph and not in the origin
 	vector< set<Node> > getFillEdges(const Graph& origin) const;
 	// If this is a triangulation of origin, returns the number of fill edges
@@ -36,6 +55,12 @@ public:
 	void printTriangulation(const Graph& origin, ofstream& writeFile) const;
 	// Prints a clique of the largest size
 	void printMaximumClique() const;
+private:
+	// The search behind getMaximalCliques. Sets the width and exponential
+	// bags size of the tree, and collects its maximal cliques and minimal
+	// separators if asked to.
+	void searchCliqueTree(CliqueTree& tree, bool keepCliques,
+			bool keepSeparators) const;
 };
 
 } /* namespace tdenum */
@@ -15,9 +15,18 @@ ChordalGraph Converter::minimalSeparatorsToTriangulation(const Graph& g,
 	triangulation.saturateNodeSets(minimalSeparators);
 	return triangulation;
 }
+ChordalGraph Converter::minimalSeparatorsToTriangulation(const Graph& g,
+		const set<NodeSetId>& minimalSeparators, const NodeSetPool& pool) {
+	ChordalGraph triangulation(g);
+	for (set<NodeSetId>::const_iterator it = minimalSeparators.begin();
+			it != minimalSeparators.end(); ++it) {
+		triangulation.addClique(pool.get(*it));
+	}
+	return triangulation;
+}
 
 /*
- * Input: a chordal graph
+ * Input: a chordal graph, or a triangulated view of a graph
  *
  * Calculates the minimal separators according to the algorithm described in:
  * P. Kumar and C. Madhavan. Minimal vertex separators of chordal graphs.
@@ -28,11 +37,11 @@ ChordalGraph Converter::minimalSeparatorsToTriangulation(const Graph& g,
  * is smaller or equal to the previous weight, these neighbors form a minimal
  * separator.
  */
-set<MinimalSeparator> Converter::triangulationToMinimalSeparators(
-		const ChordalGraph& g) {
+template<class G>
+static set<MinimalSeparator> getMinimalSeparatorsOfChordalGraph(const G& g) {
 	// initialize structures
 	set<MinimalSeparator> minimalSeparators; // holds the result
-	map<Node, bool> isVisited; // default is false
+	vector<bool> isVisited(g.getNumberOfNodes(), false);
 	IncreasingWeightNodeQueue queue(g.getNumberOfNodes());
 	int previousNumberOfNeighbors = -1;
 	// start search
@@ -42,31 +51,39 @@ set<MinimalSeparator> Converter::triangulationToMinimalSeparators(
 		int currentNumberOfNeighbors = queue.getWeight(currentNode);
 		// Add a new minimal separator if relevant
 		if (currentNumberOfNeighbors <= previousNumberOfNeighbors) {
-			// add visited neighbors of currentNode to minimalSeparators
-			NodeSetProducer separatorProducer(g.getNumberOfNodes());
-			for (set<Node>::iterator i = g.getNeighbors(currentNode).begin();
-					i!=g.getNeighbors(currentNode).end(); ++i) {
-				if (isVisited[*i]) {
-					separatorProducer.insert(*i);
+			// add visited neighbors of currentNode to minimalSeparators.
+			// The neighbors are iterated in ascending order, so it's sorted.
+			MinimalSeparator currentSeparator;
+			forEachNeighbor(g, currentNode, [&](Node u) {
+				if (isVisited[u]) {
+					currentSeparator.push_back(u);
 				}
-			}
-			MinimalSeparator currentSeparator = separatorProducer.produce();
+			});
 			if (!currentSeparator.empty()) {
 				minimalSeparators.insert(currentSeparator);
 			}
 		}
 		// Update structures
-		for (set<Node>::iterator i = g.getNeighbors(currentNode).begin();
-				i!=g.getNeighbors(currentNode).end(); ++i) {
-			if (!isVisited[*i]) {
-				queue.increaseWeight(*i);
+		forEachNeighbor(g, currentNode, [&](Node u) {
+			if (!isVisited[u]) {
+				queue.increaseWeight(u);
 			}
-		}
+		});
 		isVisited[currentNode] = true;
 		previousNumberOfNeighbors = currentNumberOfNeighbors;
 	}
 	return minimalSeparators;
 }
 
+set<MinimalSeparator> Converter::triangulationToMinimalSeparators(
+		const ChordalGraph& g) {
+	return getMinimalSeparatorsOfChordalGraph(g);
+}
+
+set<MinimalSeparator> Converter::triangulationToMinimalSeparators(
+		const OverlayGraph& g) {
+	return getMinimalSeparatorsOfChordalGraph(g);
+}
+
 } /* namespace tdenum */
 
@@ -3,6 +3,7 @@
 
 #include "Graph.h"
 #include "ChordalGraph.h"
+#include "OverlayGraph.h"
 #include <set>
 
 namespace tdenum {
@@ -23,6 +24,9 @@ public:
 	 */
 	static ChordalGraph minimalSeparatorsToTriangulation(const Graph& g,
 			const set<MinimalSeparator>& minimalSeparators);
+	// Same, with the separators given by their IDs in the pool
+	static ChordalGraph minimalSeparatorsToTriangulation(const Graph& g,
+			const set<NodeSetId>& minimalSeparators, const NodeSetPool& pool);
 	/**
 	 * Receives a chordal graph, and returns its minimal separators.
 	 * If this is a minimal triagulation of some other graph, the result is a
@@ -30,6 +34,8 @@ public:
 	 */
 	static set<MinimalSeparator> triangulationToMinimalSeparators(
 			const ChordalGraph& triangulation);
+	static set<MinimalSeparator> triangulationToMinimalSeparators(
+			const OverlayGraph& triangulation);
 };
 
 } /* namespace tdenum */
@@ -10,32 +10,127 @@
 
 namespace tdenum {
 
-IncreasingWeightNodeQueue::IncreasingWeightNodeQueue(int numberOfNodes) :
-		weight(numberOfNodes, 0) {
-	vector< pair<int,Node> > temporaryQueue;
+IncreasingWeightNodeQueue::IncreasingWeightNodeQueue(int numberOfNodes) {
+	reset(numberOfNodes);
+}
+void IncreasingWeightNodeQueue::reset(int numberOfNodes) {
+	weight.assign(numberOfNodes, 0);
+	bucketHead.assign(numberOfNodes+1, -1);
+	next.assign(numberOfNodes, -1);
+	prev.assign(numberOfNodes, -1);
+	popped.assign(numberOfNodes, false);
+	maxWeight = 0;
+	numberOfNodesInQueue = numberOfNodes;
 	for (Node v = 0; v<numberOfNodes; v++) {
-		temporaryQueue.push_back(pair<int,Node> (0,v));
+		link(v);
+	}
+}
+// Adds v at the head of the bucket of its weight
+void IncreasingWeightNodeQueue::link(Node v) {
+	int w = weight[v];
+	if (w >= (int)bucketHead.size()) {
+		bucketHead.resize(w+1, -1);
+	}
+	prev[v] = -1;
+	next[v] = bucketHead[w];
+	if (next[v] != -1) {
+		prev[next[v]] = v;
+	}
+	bucketHead[w] = v;
+	if (w > maxWeight) {
+		maxWeight = w;
+	}
+}
+void IncreasingWeightNodeQueue::unlink(Node v) {
+	if (prev[v] != -1) {
+		next[prev[v]] = next[v];
+	} else {
+		bucketHead[weight[v]] = next[v];
+	}
+	if (next[v] != -1) {
+		prev[next[v]] = prev[v];
 	}
-	queue = set< pair<int,Node> >(temporaryQueue.begin(), temporaryQueue.end());
 }
 void IncreasingWeightNodeQueue::increaseWeight(Node v) {
-	queue.erase(pair<int,Node> (weight[v],v));
+	if (popped[v]) {
+		weight[v]++;
+		return;
+	}
+	unlink(v);
 	weight[v]++;
-	queue.insert(pair<int,Node> (weight[v],v));
+	link(v);
 }
 int IncreasingWeightNodeQueue::getWeight(Node v) {
 	return weight[v];
 }
 bool IncreasingWeightNodeQueue::isEmpty() {
-	return queue.empty();
+	return numberOfNodesInQueue == 0;
 }
 Node IncreasingWeightNodeQueue::pop() {
-	pair<int,Node> current = *queue.rbegin();
-	Node v = current.second;
-	queue.erase(current);
+	while (bucketHead[maxWeight] == -1) {
+		maxWeight--;
+	}
+	Node v = bucketHead[maxWeight];
+	unlink(v);
+	popped[v] = true;
+	numberOfNodesInQueue--;
 	return v;
 }
 
+UpdatableWeightNodeQueue::UpdatableWeightNodeQueue(const vector<int>& weights) :
+		weight(weights), heap(weights.size()), position(weights.size()) {
+	for (Node v = 0; v<(int)weights.size(); v++) {
+		place(v, v);
+	}
+	for (int i = heap.size()/2 - 1; i >= 0; i--) {
+		siftDown(i);
+	}
+}
+void UpdatableWeightNodeQueue::siftUp(int i) {
+	Node v = heap[i];
+	while (i > 0 && before(v, heap[(i-1)/2])) {
+		place(i, heap[(i-1)/2]);
+		i = (i-1)/2;
+	}
+	place(i, v);
+}
+void UpdatableWeightNodeQueue::siftDown(int i) {
+	Node v = heap[i];
+	int size = heap.size();
+	while (2*i+1 < size) {
+		int child = 2*i+1;
+		if (child+1 < size && before(heap[child+1], heap[child])) {
+			child++;
+		}
+		if (!before(heap[child], v)) {
+			break;
+		}
+		place(i, heap[child]);
+		i = child;
+	}
+	place(i, v);
+}
+void UpdatableWeightNodeQueue::setWeight(Node v, int w) {
+	int old = weight[v];
+	weight[v] = w;
+	if (w < old) {
+		siftUp(position[v]);
+	} else if (w > old) {
+		siftDown(position[v]);
+	}
+}
+Node UpdatableWeightNodeQueue::pop() {
+	Node top = heap[0];
+	Node last = heap.back();
+	heap.pop_back();
+	position[top] = -1;
+	if (!heap.empty()) {
+		place(0, last);
+		siftDown(0);
+	}
+	return top;
+}
+
 bool WeightedNodeSetQueue::isEmpty() {
 	return queue.empty();
 }
@@ -51,7 +146,7 @@ vector<Node> WeightedNodeSetQueue::pop() {
 	return nodeVec;
 }
 
-NodeSetSet::NodeSetSet(const set<NodeSet>& s) : sets(s) {}
+NodeSetSet::NodeSetSet(const set<NodeSet>& s) : sets(s.begin(), s.end()) {}
 bool NodeSetSet::isMember(const vector<Node>& nodeVec) const {
 	return sets.find(nodeVec) != sets.end();
 }
@@ -59,10 +154,11 @@ string NodeSetSet::str() const {
     if (empty()) {
         return string("{}");
     }
+    vector<NodeSet> ordered = sorted();
     ostringstream oss;
     oss << "\{ ";
-    for(auto it = begin(); it != end(); ++it) {
-		if (it != begin())
+    for(auto it = ordered.begin(); it != ordered.end(); ++it) {
+		if (it != ordered.begin())
 			oss << ",";
 		if (it->size() == 0) {
             oss << "\{}";
@@ -91,6 +187,11 @@ void NodeSetSet::insert(const NodeSet& nodeVec) {
 void NodeSetSet::remove(const NodeSet& nodeVec) {
     sets.erase(nodeVec);
 }
+vector<NodeSet> NodeSetSet::sorted() const {
+	vector<NodeSet> result(sets.begin(), sets.end());
+	std::sort(result.begin(), result.end());
+	return result;
+}
 NodeSetSet NodeSetSet::unify(const NodeSetSet& other) const {
 	NodeSetSet result = other;
 	for (auto ns = begin(); ns != end(); ns++)
@@ -112,18 +213,115 @@ bool NodeSetSet::empty() const {
 void NodeSetSet::clear() {
     sets.clear();
 }
-set<NodeSet>::iterator NodeSetSet::begin() const {
+NodeSetSet::iterator NodeSetSet::begin() const {
     return sets.begin();
 }
-set<NodeSet>::iterator NodeSetSet::end() const {
+NodeSetSet::iterator NodeSetSet::end() const {
     return sets.end();
 }
-set<NodeSet>::iterator NodeSetSet::find(const NodeSet& nodeSet) const {
+NodeSetSet::iterator NodeSetSet::find(const NodeSet& nodeSet) const {
     return sets.find(nodeSet);
 }
 
 
 
+NodeSetId NodeSetPool::intern(const NodeSet& nodeSet) {
+	NodeSetFingerprint fp = nodeSetFingerprint(nodeSet);
+	auto range = index.equal_range(fp);
+	for (auto it = range.first; it != range.second; ++it) {
+		if (sets[it->second] == nodeSet) {
+			return it->second;
+		}
+	}
+	NodeSetId id = sets.size();
+	sets.push_back(nodeSet);
+	index.insert(make_pair(fp, id));
+	return id;
+}
+set<NodeSetId> NodeSetPool::intern(const set<NodeSet>& nodeSets) {
+	set<NodeSetId> ids;
+	for (auto it = nodeSets.begin(); it != nodeSets.end(); ++it) {
+		ids.insert(intern(*it));
+	}
+	return ids;
+}
+bool NodeSetPool::lookup(const NodeSet& nodeSet, NodeSetId& id) const {
+	auto range = index.equal_range(nodeSetFingerprint(nodeSet));
+	for (auto it = range.first; it != range.second; ++it) {
+		if (sets[it->second] == nodeSet) {
+			id = it->second;
+			return true;
+		}
+	}
+	return false;
+}
+set<NodeSet> NodeSetPool::get(const set<NodeSetId>& ids) const {
+	set<NodeSet> nodeSets;
+	for (auto it = ids.begin(); it != ids.end(); ++it) {
+		nodeSets.insert(sets[*it]);
+	}
+	return nodeSets;
+}
+
+BitMatrix::BitMatrix(int rows, int columns) {
+	reset(rows, columns);
+}
+void BitMatrix::reset(int rows, int columns) {
+	numberOfRows = rows;
+	wordsPerRow = wordsFor(columns);
+	words.assign(numberOfRows*wordsPerRow, 0);
+}
+void BitMatrix::clearRow(int r) {
+	std::fill(row(r), row(r) + wordsPerRow, 0ULL);
+}
+vector<int> BitMatrix::toNodeSet(const BitWord* w, int numberOfWords) {
+	vector<int> result;
+	for (int i=0; i<numberOfWords; i++) {
+		BitWord word = w[i];
+		while (word) {
+			result.push_back(i*BITWORD_BITS + popLowestBit(word));
+		}
+	}
+	return result;
+}
+
+ostream& operator<<(ostream& os, const NodeRange& r) {
+	os << "{";
+	for (const Node* it = r.begin(); it != r.end(); ++it) {
+		if (it != r.begin())
+			os << ",";
+		os << *it;
+	}
+	os << "}";
+	return os;
+}
+
+void FlatBlockVec::push_back(vector<Node>& sep, vector<Node>& comp) {
+	std::sort(sep.begin(), sep.end());
+	std::sort(comp.begin(), comp.end());
+	nodes.insert(nodes.end(), sep.begin(), sep.end());
+	offsets.push_back(nodes.size());
+	nodes.insert(nodes.end(), comp.begin(), comp.end());
+	offsets.push_back(nodes.size());
+}
+void FlatBlockVec::push_back(const BitWord* sepWords, const BitWord* compWords, int numberOfWords) {
+	for (int i=0; i<numberOfWords; i++) {
+		BitWord word = sepWords[i];
+		while (word) {
+			nodes.push_back(i*BITWORD_BITS + BitMatrix::popLowestBit(word));
+		}
+	}
+	offsets.push_back(nodes.size());
+	for (int i=0; i<numberOfWords; i++) {
+		BitWord word = compWords[i];
+		while (word) {
+			nodes.push_back(i*BITWORD_BITS + BitMatrix::popLowestBit(word));
+		}
+	}
+	offsets.push_back(nodes.size());
+}
+
+
 NodeSetProducer::NodeSetProducer(int sizeOfOriginalNodeSet) :
 		isMember(sizeOfOriginalNodeSet, false), numMembers(0) {}
 void NodeSetProducer::insert(Node v) {
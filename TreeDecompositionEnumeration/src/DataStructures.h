@@ -10,6 +10,9 @@
 
 #include <vector>
 #include <set>
+#include <unordered_set>
+#include <unordered_map>
+#include <deque>
 #include <algorithm>
 #include <string>
 #include <memory>
@@ -24,6 +27,8 @@ namespace tdenum {
 typedef int Node;
 typedef vector<Node> NodeSet; // sorted vector of node names
 typedef NodeSet MinimalSeparator;
+typedef unsigned long long BitWord; // For bit-packed node sets
+#define BITWORD_BITS 64
 
 /**
  * Noam's structure
@@ -43,22 +48,109 @@ struct Block {
 typedef shared_ptr<Block> BlockPtr;
 typedef vector<BlockPtr> BlockVec;
 
+/*
+ * A read-only view of a sorted run of nodes stored in some other buffer.
+ * Valid as long as the buffer isn't modified.
+ */
+struct NodeRange {
+	const Node* first;
+	const Node* last;
+	NodeRange(const Node* f, const Node* l) : first(f), last(l) {}
+	const Node* begin() const { return first; }
+	const Node* end() const { return last; }
+	unsigned int size() const { return last - first; }
+	bool empty() const { return first == last; }
+	Node operator[](unsigned int i) const { return first[i]; }
+	bool operator==(const NodeSet& nodeSet) const {
+		return size() == nodeSet.size() && std::equal(first, last, nodeSet.begin());
+	}
+	bool operator!=(const NodeSet& nodeSet) const { return !(*this == nodeSet); }
+	bool contains(Node v) const { return std::binary_search(first, last, v); }
+	NodeSet toNodeSet() const { return NodeSet(first, last); }
+	friend ostream& operator<<(ostream& os, const NodeRange&);
+};
+
+/*
+ * The blocks of a graph, stored flat: the separator and component of each
+ * block are consecutive sorted runs in a single node buffer, so there are
+ * no per-block objects. Clearing keeps the buffers allocated.
+ */
+class FlatBlockVec {
+	vector<Node> nodes;
+	// Block i's S is [offsets[2i], offsets[2i+1]), its C is [offsets[2i+1], offsets[2i+2])
+	vector<int> offsets;
+public:
+	FlatBlockVec() : offsets(1, 0) {}
+	void clear() { nodes.clear(); offsets.resize(1); }
+	unsigned int size() const { return offsets.size() / 2; }
+	bool empty() const { return size() == 0; }
+	NodeRange S(int i) const {
+		return NodeRange(nodes.data() + offsets[2*i], nodes.data() + offsets[2*i+1]);
+	}
+	NodeRange C(int i) const {
+		return NodeRange(nodes.data() + offsets[2*i+1], nodes.data() + offsets[2*i+2]);
+	}
+	// Appends a block. The nodes are sorted in place before they're copied.
+	void push_back(vector<Node>& sep, vector<Node>& comp);
+	// Appends a block with the given bit-packed S and C.
+	void push_back(const BitWord* sepWords, const BitWord* compWords, int numberOfWords);
+};
+
 /**
  * Utility functions
  */
 string str_nodeset(const NodeSet&);
 void print(const NodeSet&);
 
+/*
+ * Order independent 64-bit fingerprints of node sets: the fingerprint of a set
+ * is the sum of the (mixed) fingerprints of its nodes, so adding or removing a
+ * node updates it in O(1).
+ */
+typedef unsigned long long NodeSetFingerprint;
+inline NodeSetFingerprint nodeFingerprint(Node v) {
+	// splitmix64 finalizer
+	NodeSetFingerprint x = (NodeSetFingerprint)v + 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+inline NodeSetFingerprint nodeSetFingerprint(const NodeSet& nodeSet) {
+	NodeSetFingerprint fp = 0;
+	for (Node v : nodeSet) {
+		fp += nodeFingerprint(v);
+	}
+	return fp;
+}
+struct NodeSetHash {
+	size_t operator()(const NodeSet& nodeSet) const {
+		return (size_t)nodeSetFingerprint(nodeSet);
+	}
+};
+
 /*
  * A maximum heap. Can be used for Maximum Cardinality Search.
+ * Implemented as buckets of doubly linked nodes, one bucket per weight, so
+ * increaseWeight is O(1) and pop is amortized O(1). Nodes of equal weight
+ * are popped last-in first-out (initially, from the highest node down).
  */
 class IncreasingWeightNodeQueue {
 	vector<int> weight;
-	set< pair<int,Node> > queue;
+	vector<Node> bucketHead; // First node of each weight, or -1
+	vector<Node> next, prev; // Links within a bucket, -1 terminated
+	vector<bool> popped;
+	int maxWeight; // No node in the queue has a higher weight
+	int numberOfNodesInQueue;
+	void link(Node v);
+	void unlink(Node v);
 public:
-	IncreasingWeightNodeQueue(int numberOfNodes);
+	IncreasingWeightNodeQueue(int numberOfNodes = 0);
+	// Puts all nodes back in the queue with weight 0. Reuses the allocated
+	// space if the number of nodes doesn't grow.
+	void reset(int numberOfNodes);
 	// Increase the weight of the node by 1.
-	// Node is assumed to be an integer between 0 and numberOfNodes-1.
+	// Node is assumed to be an integer between 0 and numberOfNodes-1 that
+	// wasn't popped yet.
 	void increaseWeight(Node v);
 	// Returns the weight of the node. This is also available after pop.
 	// Node is assumed to be an integer between 0 and numberOfNodes-1.
@@ -69,6 +161,34 @@ public:
 	Node pop();
 };
 
+/*
+ * A minimum heap of nodes whose weights can be changed while in the heap.
+ * Nodes of equal weight are popped by ascending node.
+ * A binary heap with a position index: pop and setWeight are O(log n).
+ */
+class UpdatableWeightNodeQueue {
+	vector<int> weight;
+	vector<Node> heap;
+	vector<int> position; // Index of each node in heap, -1 if not in it
+	bool before(Node u, Node v) const {
+		return weight[u] < weight[v] || (weight[u] == weight[v] && u < v);
+	}
+	void place(int i, Node v) { heap[i] = v; position[v] = i; }
+	void siftUp(int i);
+	void siftDown(int i);
+public:
+	// Initializes the queue with all nodes, where the weight of node v is weights[v].
+	UpdatableWeightNodeQueue(const vector<int>& weights);
+	// Sets the weight of the node, which should be in the queue.
+	void setWeight(Node v, int w);
+	int getWeight(Node v) const { return weight[v]; }
+	// True if the node wasn't popped yet.
+	bool contains(Node v) const { return position[v] != -1; }
+	bool isEmpty() const { return heap.empty(); }
+	// Returns and removes the node with the minimal weight.
+	Node pop();
+};
+
 /*
  * A minimum heap.
  */
@@ -85,9 +205,15 @@ public:
 	NodeSet pop();
 };
 
+/*
+ * A set of node sets, hashed by fingerprint. Iteration order is arbitrary;
+ * use sorted() where the order matters.
+ */
 class NodeSetSet {
-	set< NodeSet > sets;
+	unordered_set< NodeSet, NodeSetHash > sets;
 public:
+	typedef unordered_set< NodeSet, NodeSetHash >::const_iterator iterator;
+	typedef iterator const_iterator;
     NodeSetSet(const set<NodeSet>& = set<NodeSet>());
     // True if the structure contains the given node set.
 	bool isMember(const NodeSet& nodeSet) const;
@@ -97,20 +223,104 @@ public:
 	void insert(const NodeSet& nodeSet);
 	void remove(const NodeSet& nodeSet);
 	NodeSetSet unify(const NodeSetSet& other) const;
-	// Prints out the NodeSets
+	// Returns the node sets in lexicographic order
+	vector<NodeSet> sorted() const;
+	// Prints out the NodeSets, in lexicographic order
 	string str() const;
 	// std::set methods
 	unsigned int size() const;
 	bool empty() const;
 	void clear();
-	set<NodeSet>::iterator begin() const;
-	set<NodeSet>::iterator end() const;
-	set<NodeSet>::iterator find(const NodeSet& nodeSet) const;
-	operator set<NodeSet>() const { return sets; }
+	iterator begin() const;
+	iterator end() const;
+	iterator find(const NodeSet& nodeSet) const;
+	operator set<NodeSet>() const { return set<NodeSet>(sets.begin(), sets.end()); }
 	friend ostream& operator<<(ostream& os, const NodeSetSet&);
 };
 
 
+/*
+ * Stores each distinct node set once and hands out compact IDs for it, so
+ * structures holding many copies of the same sets (e.g. the sets of minimal
+ * separators in the triangulations enumerator) can hold IDs instead.
+ * IDs are consecutive, starting at 0, in the order the sets were first seen.
+ * References returned by get() are valid as long as the pool is.
+ */
+typedef unsigned int NodeSetId;
+class NodeSetPool {
+	deque<NodeSet> sets;
+	unordered_multimap<NodeSetFingerprint, NodeSetId> index;
+public:
+	// Returns the ID of the given node set, adding it to the pool if needed.
+	NodeSetId intern(const NodeSet& nodeSet);
+	set<NodeSetId> intern(const set<NodeSet>& nodeSets);
+	// Sets id to the ID of the given node set. Returns false if the node set
+	// isn't in the pool.
+	bool lookup(const NodeSet& nodeSet, NodeSetId& id) const;
+	// Returns the node set(s) of the given ID(s)
+	const NodeSet& get(NodeSetId id) const { return sets[id]; }
+	set<NodeSet> get(const set<NodeSetId>& ids) const;
+	unsigned int size() const { return sets.size(); }
+};
+
+/*
+ * A rows x columns table of bits, each row packed into 64-bit words.
+ * Used for dense adjacency matrices and other node-indexed boolean tables,
+ * where word-wide AND / OR replaces per-element lookups.
+ */
+class BitMatrix {
+	int numberOfRows;
+	int wordsPerRow;
+	vector<BitWord> words;
+public:
+	BitMatrix(int rows = 0, int columns = 0);
+	// Resizes the table and clears all bits.
+	void reset(int rows, int columns);
+	int getNumberOfRows() const { return numberOfRows; }
+	int getWordsPerRow() const { return wordsPerRow; }
+	bool test(int row, int column) const {
+		return (words[row*wordsPerRow + column/BITWORD_BITS] >> (column%BITWORD_BITS)) & 1ULL;
+	}
+	void set(int row, int column) {
+		words[row*wordsPerRow + column/BITWORD_BITS] |= 1ULL << (column%BITWORD_BITS);
+	}
+	void clear(int row, int column) {
+		words[row*wordsPerRow + column/BITWORD_BITS] &= ~(1ULL << (column%BITWORD_BITS));
+	}
+	const BitWord* row(int r) const { return words.data() + r*wordsPerRow; }
+	BitWord* row(int r) { return words.data() + r*wordsPerRow; }
+	void clearRow(int r);
+	// Number of words needed to hold the given number of bits
+	static int wordsFor(int bits) { return (bits + BITWORD_BITS - 1) / BITWORD_BITS; }
+	// Returns the indices of the set bits of the given words, sorted ascending
+	static vector<int> toNodeSet(const BitWord* w, int numberOfWords);
+	// Removes the lowest set bit of a non-zero word and returns its index
+	static int popLowestBit(BitWord& w) {
+		int i = __builtin_ctzll(w);
+		w &= w - 1;
+		return i;
+	}
+};
+
+/*
+ * Scratch space for Graph::getBlocks, owned by the caller and reused between
+ * calls so that finding the blocks doesn't allocate anything once warm.
+ * The result of the last call is kept here as well.
+ * Not thread safe; use one per thread.
+ */
+class BlocksWorkspace {
+	friend class Graph;
+	FlatBlockVec blocks;
+	vector<int> visited; // -1 removed, 0 not yet reached, 1 in some component,
+	                     // 2 out of the subgraph
+	vector<int> separatorOf; // The last block a removed node was added to
+	vector<Node> bfsQueue;
+	vector<Node> separator;
+	vector<BitWord> unvisitedWords, removedWords, sepWords, compWords;
+public:
+	const FlatBlockVec& getBlocks() const { return blocks; }
+};
+
 /*
  * Constructs a subset of nodes in linear time in the size of the original set.
  */
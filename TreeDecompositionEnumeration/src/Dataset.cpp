@@ -3,6 +3,7 @@
 #include "MinimalTriangulationsEnumerator.h"
 #include "PMCRacer.h"
 #include "StatisticRequest.h"
+#include <cmath>
 
 namespace tdenum {
 
@@ -150,7 +151,10 @@ Dataset& Dataset::calc_ms(GraphStats& gs, const StatisticRequest& sr) {
     // Init
     NodeSetSet min_seps;
     MinimalSeparatorsEnumerator mse(gs.get_graph(), UNIFORM);
-    time_t t = time(NULL);
+    CancellationToken token(cancellation);
+    if (sr.test_time_limit_ms()) {
+        token.setTimeLimit(sr.get_time_limit_ms());
+    }
     min_seps.clear();
     long ms_count = 0;
     gs.set_ms_count(ms_count);
@@ -159,13 +163,12 @@ Dataset& Dataset::calc_ms(GraphStats& gs, const StatisticRequest& sr) {
     // Catch memory errors
     try {
         TRACE(TRACE_LVL__TEST, "In try\{} block with the following graph:\n" << gs.get_graph());
-        time_t start_time = time(NULL);
         while(mse.hasNext()) {
             // No need to store the separators if they weren't requested.
             // We do need to advance the MS enumerator, though.
             auto next = mse.next();
             ++ms_count;
-            time_t time_taken = difftime(time(NULL), start_time);
+            time_t time_taken = llround(token.getElapsedSeconds());
 
             // Set count AFTER setting (possible) separators, as the above updates the count automatically.
             if (sr.test_ms()) {
@@ -187,7 +190,7 @@ Dataset& Dataset::calc_ms(GraphStats& gs, const StatisticRequest& sr) {
                 gs.set_reached_count_limit_ms();
                 break;
             }
-            if (sr.test_time_limit_ms() && gs.get_ms_calc_time() > sr.get_time_limit_ms()) {
+            if (token.isCancelled()) {
                 TRACE(TRACE_LVL__WARNING, "Reached time limit in MS calculation for graph '"
                             << gs.get_text() << "' (used "
                             << gs.get_ms_calc_time() << " seconds, limited to "
@@ -203,7 +206,7 @@ Dataset& Dataset::calc_ms(GraphStats& gs, const StatisticRequest& sr) {
     }
     // That's it.
     end_progress_report();
-    gs.set_ms_calc_time(difftime(time(NULL),t));// If there are no separators, this is never updated
+    gs.set_ms_calc_time(llround(token.getElapsedSeconds()));// If there are no separators, this is never updated
     TRACE(TRACE_LVL__TEST, "Timestamp difference: " << gs.get_ms_calc_time());
     TRACE(TRACE_LVL__TEST, "Timestamp in hhmmss format: " << utils__timestamp_to_hhmmss(gs.get_ms_calc_time()));
     TRACE(TRACE_LVL__TEST,"SET MS COUNT TO " << gs.get_ms_count());
@@ -214,6 +217,7 @@ Dataset& Dataset::calc_pmc(GraphStats& gs, const StatisticRequest& sr) {
     CALC_SANITY(pmc_calculation);
 
     PMCRacer pmcr("tmp", false);
+    pmcr.set_cancellation_token(cancellation);
     pmcr.add(gs);
     TRACE(TRACE_LVL__TEST, "In");
     pmcr.go(sr, verbose);
@@ -284,9 +288,13 @@ Dataset& Dataset::calc_trng(GraphStats& gs, const StatisticRequest& sr) {
 
     CALC_SANITY(trng_calculation);
 
-    // Init
-    time_t start_time = time(NULL);
+    // Init. The token also stops the enumerator between triangulations.
+    CancellationTokenPtr token = make_shared<CancellationToken>(cancellation);
+    if (sr.test_time_limit_trng()) {
+        token->setTimeLimit(sr.get_time_limit_trng());
+    }
     MinimalTriangulationsEnumerator mte(gs.get_graph(), NONE, UNIFORM, MCS_M);
+    mte.setCancellationToken(token);
     long trng_count = 0;
     gs.set_trng_count(trng_count);
     gs.set_trng(vector<ChordalGraph>());
@@ -296,12 +304,13 @@ Dataset& Dataset::calc_trng(GraphStats& gs, const StatisticRequest& sr) {
         while (mte.hasNext()) {
             // Calculate
             ++trng_count;
-            ChordalGraph triangulation = mte.next();
-            time_t time_taken = difftime(time(NULL), start_time);
+            // Only build the triangulation if it's kept
+            TriangulationHandle triangulation = mte.nextHandle();
+            time_t time_taken = llround(token->getElapsedSeconds());
             // Update fields
             gs.set_trng_calc_time(time_taken);
             if (sr.test_trng()) {
-                gs.add_trng(triangulation);
+                gs.add_trng(triangulation.getTriangulation());
             }
             // Set count AFTER setting (possible) triangulations, as the above updates the count automatically.
             gs.set_trng_count(trng_count);
@@ -315,15 +324,18 @@ Dataset& Dataset::calc_trng(GraphStats& gs, const StatisticRequest& sr) {
                 gs.set_reached_count_limit_trng();
                 return *this;
             }
-            if (sr.test_time_limit_trng() && sr.get_time_limit_trng() < time_taken) {
-                TRACE(TRACE_LVL__WARNING, "Reached time limit in TRNG calculation for graph '"
-                                << gs.get_text() << "' (took "
-                                << time_taken << " seconds, limited to "
-                                << sr.get_time_limit_trng() << ")");
-                gs.set_reached_time_limit_trng();
-                return *this;
+            if (token->isCancelled()) {
+                break;
             }
         }
+        if (token->isCancelled()) {
+            TRACE(TRACE_LVL__WARNING, "Reached time limit in TRNG calculation for graph '"
+                            << gs.get_text() << "' (took "
+                            << token->getElapsedSeconds() << " seconds, limited to "
+                            << sr.get_time_limit_trng(true) << ")");
+            gs.set_reached_time_limit_trng();
+            return *this;
+        }
     }
     catch (std::bad_alloc) {
         TRACE(TRACE_LVL__ERROR, "Memory error when calculating triangulations!");
@@ -470,6 +482,7 @@ Dataset& Dataset::set_all_requests(const StatisticRequest& sr) {
 }
 Dataset& Dataset::set_verbose() { verbose = true; return *this; }
 Dataset& Dataset::unset_verbose() { verbose = false; return *this; }
+Dataset& Dataset::set_cancellation_token(CancellationTokenPtr t) { cancellation = t; return *this; }
 
 string Dataset::get_file_path() const { return file_path; }
 
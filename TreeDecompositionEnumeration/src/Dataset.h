@@ -145,6 +145,7 @@ private:
     string file_path;       // Path to file containing statistics / dump target
     bool verbose;           // If true, progress reports will be displayed
     bool dump_each_graph;   // If true, each calculated graph will dump a row to the dump target
+    CancellationTokenPtr cancellation; // Stops the calculations (may be NULL)
 
     // These print out CSV strings for output.
     // An entry will use the StatisticRequest object to determine which
@@ -272,6 +273,10 @@ public:
     Dataset& set_verbose();
     Dataset& unset_verbose();
 
+    // Stops the calculations once the token is cancelled, as if their time
+    // limits were reached. Every calculation gets a token derived from it.
+    Dataset& set_cancellation_token(CancellationTokenPtr);
+
     // Get the output path
     string get_file_path() const;
 
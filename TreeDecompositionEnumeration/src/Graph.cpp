@@ -11,10 +11,12 @@
 namespace tdenum {
 
 Graph::Graph() : Graph(0) {}
-Graph::Graph(int numNodes) :
+Graph::Graph(int numNodes, AdjacencyBackend a) :
             numberOfNodes(numNodes),
             numberOfEdges(0),
             neighborSets(numberOfNodes),
+            adjacency(a),
+            adjacencyMatrix(a == ADJACENCY_BITSET ? numNodes : 0, a == ADJACENCY_BITSET ? numNodes : 0),
             isRandomGraph(false),
             p(-1),
             instance(1),
@@ -26,10 +28,37 @@ Graph::Graph(int numNodes) :
 }
 
 Graph& Graph::reset(int n) {
-    *this = Graph(n);
+    *this = Graph(n, adjacency);
     return *this;
 }
 
+Graph& Graph::setAdjacency(AdjacencyBackend a) {
+    if (a != adjacency) {
+        adjacency = a;
+        rebuildAdjacencyMatrix();
+    }
+    return *this;
+}
+AdjacencyBackend Graph::getAdjacency() const { return adjacency; }
+AdjacencyBackend Graph::preferredAdjacency(int n) {
+    return n <= GRAPH_BITSET_MAX_NODES ? ADJACENCY_BITSET : ADJACENCY_SETS;
+}
+
+// Recalculates the bit-matrix from the neighbor sets (or frees it, if the
+// bit-matrix isn't used).
+void Graph::rebuildAdjacencyMatrix() {
+    if (adjacency != ADJACENCY_BITSET) {
+        adjacencyMatrix = BitMatrix();
+        return;
+    }
+    adjacencyMatrix.reset(numberOfNodes, numberOfNodes);
+    for (Node u=0; u<numberOfNodes; ++u) {
+        for (Node v: neighborSets[u]) {
+            adjacencyMatrix.set(u,v);
+        }
+    }
+}
+
 bool Graph::nodeSanity() const {
     TRACE(TRACE_LVL__WARNING, "Called nodeSanity(), this will take " << numberOfNodes*(numberOfNodes-1)/2 << " steps!");
     for (Node u=0; u<numberOfNodes; ++u) {
@@ -56,6 +85,7 @@ Graph& Graph::randomize(double pr, int inst) {
     for (int i=0; i<numberOfNodes; ++i) {
         neighborSets[i].clear();
     }
+    rebuildAdjacencyMatrix();
 
     NodeSet nodes = getNodesVector();
     double d;
@@ -109,6 +139,7 @@ Graph& Graph::removeAllButFirstK(int k) {
     }
     numberOfNodes = k;
     numberOfEdges = E/2;
+    rebuildAdjacencyMatrix();
     return *this;
 }
 
@@ -145,6 +176,7 @@ vector<Node> Graph::nodeRenameAux(const vector<Node>& oldToNew) {
         }
     }
     neighborSets = newNeighbors;
+    rebuildAdjacencyMatrix();
     composeNewToOld(oldToNew);
     return oldToNew;
 }
@@ -204,8 +236,19 @@ Graph& Graph::forgetOriginalNames() {
     }
     return *this;
 }
+bool Graph::isRenamed() const {
+    for(unsigned i=0; i<newToOldNames.size(); ++i) {
+        if (newToOldNames[i] != (Node)i) {
+            return true;
+        }
+    }
+    return false;
+}
 
 Graph& Graph::addClique(const set<Node>& newClique) {
+	if (adjacency == ADJACENCY_BITSET) {
+		return addClique(vector<Node>(newClique.begin(), newClique.end()));
+	}
 	for (set<Node>::iterator i = newClique.begin(); i != newClique.end(); ++i) {
 		Node v = *i;
 		for (set<Node>::iterator j = newClique.begin(); j != newClique.end(); ++j) {
@@ -219,6 +262,27 @@ Graph& Graph::addClique(const set<Node>& newClique) {
 }
 
 Graph& Graph::addClique(const vector<Node>& newClique) {
+	if (adjacency == ADJACENCY_BITSET && areValidNodes(newClique)) {
+		// Mask the clique, and for each member add only the missing edges
+		int words = adjacencyMatrix.getWordsPerRow();
+		vector<BitWord> cliqueMask(words, 0);
+		for (Node v : newClique) {
+			cliqueMask[v/BITWORD_BITS] |= 1ULL << (v%BITWORD_BITS);
+		}
+		for (Node v : newClique) {
+			const BitWord* row = adjacencyMatrix.row(v);
+			for (int w=0; w<words; ++w) {
+				BitWord missing = cliqueMask[w] & ~row[w];
+				while (missing) {
+					Node u = w*BITWORD_BITS + BitMatrix::popLowestBit(missing);
+					if (u < v) {
+						addEdge(u, v);
+					}
+				}
+			}
+		}
+		return *this;
+	}
 	for (vector<Node>::const_iterator i = newClique.begin(); i != newClique.end(); ++i) {
 		Node v = *i;
 		for (vector<Node>::const_iterator j = newClique.begin(); j != newClique.end(); ++j) {
@@ -232,11 +296,15 @@ Graph& Graph::addClique(const vector<Node>& newClique) {
 }
 
 Graph& Graph::addEdge(Node u, Node v) {
-	if (!isValidNode(u) || !isValidNode(v) || neighborSets[u].count(v)>0) {
+	if (!isValidNode(u) || !isValidNode(v) || areNeighbors(u,v)) {
 		return *this;
 	}
 	neighborSets[u].insert(v);
 	neighborSets[v].insert(u);
+	if (adjacency == ADJACENCY_BITSET) {
+		adjacencyMatrix.set(u,v);
+		adjacencyMatrix.set(v,u);
+	}
 	numberOfEdges++;
     return *this;
 }
@@ -264,6 +332,15 @@ bool Graph::isValidNode(Node v) const {
 	return true;
 }
 
+bool Graph::areValidNodes(const vector<Node>& nodes) const {
+	for (Node v : nodes) {
+		if (!isValidNode(v)) {
+			return false;
+		}
+	}
+	return true;
+}
+
 
 /*
  * Returns the set of nodes in the graph
@@ -341,6 +418,9 @@ vector<bool> Graph::getNeighborsMap(Node v) const {
  * nodes that are in the input node set
  */
 NodeSet Graph::getNeighbors(const set<Node>& inputSet) const {
+	if (adjacency == ADJACENCY_BITSET) {
+		return getNeighbors(vector<Node>(inputSet.begin(), inputSet.end()));
+	}
 	NodeSetProducer neighborsProducer(numberOfNodes);
 	for (set<Node>::const_iterator i = inputSet.begin(); i != inputSet.end(); ++i) {
 		Node v = *i;
@@ -358,6 +438,24 @@ NodeSet Graph::getNeighbors(const set<Node>& inputSet) const {
 }
 
 NodeSet Graph::getNeighbors(const vector<Node>& inputSet) const {
+	if (adjacency == ADJACENCY_BITSET) {
+		if (!areValidNodes(inputSet)) {
+			return NodeSet();
+		}
+		// OR the rows of the input nodes, then remove the input nodes
+		int words = adjacencyMatrix.getWordsPerRow();
+		vector<BitWord> neighbors(words, 0);
+		for (Node v : inputSet) {
+			const BitWord* row = adjacencyMatrix.row(v);
+			for (int w=0; w<words; ++w) {
+				neighbors[w] |= row[w];
+			}
+		}
+		for (Node v : inputSet) {
+			neighbors[v/BITWORD_BITS] &= ~(1ULL << (v%BITWORD_BITS));
+		}
+		return BitMatrix::toNodeSet(neighbors.data(), words);
+	}
 	NodeSetProducer neighborsProducer(numberOfNodes);
 	for (vector<Node>::const_iterator i = inputSet.begin(); i != inputSet.end(); ++i) {
 		Node v = *i;
@@ -375,6 +473,9 @@ NodeSet Graph::getNeighbors(const vector<Node>& inputSet) const {
 }
 
 bool Graph::areNeighbors(Node u, Node v) const {
+	if (adjacency == ADJACENCY_BITSET) {
+		return adjacencyMatrix.test(u,v);
+	}
 	return neighborSets[u].find(v) != neighborSets[u].end();
 }
 
@@ -443,7 +544,7 @@ bool Graph::isFullComponent(const vector<Node>& C, const vector<Node>& S) const
     for (auto s: S) {
         bool has_neighbor = false;
         for (auto c: C) {
-            if (neighborSets[s].find(c) != neighborSets[s].end()) {
+            if (areNeighbors(s,c)) {
                 has_neighbor = true;
                 break;
             }
@@ -539,71 +640,134 @@ NodeSet Graph::getAdjacent(const NodeSet& C, const NodeSet& K) const {
 }
 
 BlockVec Graph::getBlocks(const set<Node>& removedNodes) const {
-	vector<int> visitedList(numberOfNodes, 0);
-	for (set<Node>::iterator i = removedNodes.begin(); i != removedNodes.end(); ++i) {
-		Node v = *i;
-		if (!isValidNode(v)) {
-			return BlockVec();
-		}
-		visitedList[v] = -1;
-	}
-	int numberOfUnhandeledNodes = numberOfNodes - removedNodes.size();
-	return getBlocksAux(visitedList, numberOfUnhandeledNodes);
+	return getBlocks(NodeSet(removedNodes.begin(), removedNodes.end()));
 }
 
 BlockVec Graph::getBlocks(const NodeSet& removedNodes) const {
-	vector<int> visitedList(numberOfNodes, 0);
+	BlocksWorkspace ws;
+	const FlatBlockVec& flat = getBlocks(removedNodes, ws);
+	BlockVec blocks;
+	blocks.reserve(flat.size());
+	for (unsigned int i=0; i<flat.size(); i++) {
+		blocks.push_back(BlockPtr(new Block(flat.S(i).toNodeSet(),
+				flat.C(i).toNodeSet(), getNumberOfNodes())));
+	}
+	return blocks;
+}
+
+const FlatBlockVec& Graph::getBlocks(const NodeSet& removedNodes, BlocksWorkspace& ws) const {
+	return getBlocks(removedNodes, ws, numberOfNodes);
+}
+
+/*
+ * The nodes out of the prefix are marked as visited without being removed, so
+ * the searches step over them.
+ */
+const FlatBlockVec& Graph::getBlocks(const NodeSet& removedNodes, BlocksWorkspace& ws,
+		int prefixSize) const {
+	ws.blocks.clear();
+	if (!areValidNodes(removedNodes)) {
+		return ws.blocks;
+	}
+	ws.visited.assign(numberOfNodes, 0);
+	std::fill(ws.visited.begin() + prefixSize, ws.visited.end(), 2);
 	for (Node v : removedNodes) {
-		if (!isValidNode(v)) {
-			return BlockVec();
-		}
-		visitedList[v] = -1;
+		ws.visited[v] = -1;
 	}
-	int numberOfUnhandeledNodes = numberOfNodes - removedNodes.size();
-	return getBlocksAux(visitedList, numberOfUnhandeledNodes);
+	if (adjacency == ADJACENCY_BITSET) {
+		getBlocksBitsetAux(ws, prefixSize);
+	} else {
+		getBlocksAux(ws, prefixSize);
+	}
+	return ws.blocks;
 }
 
-BlockVec Graph::getBlocksAux(vector<int> visitedList, int numberOfUnhandeledNodes) const {
-	BlockVec blocks;
+void Graph::getBlocksAux(BlocksWorkspace& ws, int prefixSize) const {
+	vector<int>& visitedList = ws.visited;
+	vector<Node>& bfsQueue = ws.bfsQueue;
+	vector<Node>& separator = ws.separator;
+	ws.separatorOf.assign(numberOfNodes, -1);
 	// Finds a new component in each iteration
-	Node unhandeledID = 0;
-	while (numberOfUnhandeledNodes > 0) {
-		queue<Node> bfsQueue;
-		NodeSetProducer sepProducer(visitedList.size()),
-						compProducer(visitedList.size());
-		// Initialize the queue to contain a node not handled
-		for (; unhandeledID<numberOfNodes; unhandeledID++) {
-			if (visitedList[unhandeledID] == 0) {
-				bfsQueue.push(unhandeledID);
-				visitedList[unhandeledID] = 1;
-				compProducer.insert(unhandeledID);
-				numberOfUnhandeledNodes--;
-				unhandeledID++;
-				break;
-			}
+	for (Node unhandeledID = 0; unhandeledID<prefixSize; unhandeledID++) {
+		if (visitedList[unhandeledID] != 0) {
+			continue;
 		}
-		// BFS through the component
-		while (!bfsQueue.empty()) {
-			Node v = bfsQueue.front();
-			bfsQueue.pop();
-			for (set<Node>::iterator it = neighborSets[v].begin();
+		int blockIndex = ws.blocks.size();
+		bfsQueue.clear();
+		separator.clear();
+		bfsQueue.push_back(unhandeledID);
+		visitedList[unhandeledID] = 1;
+		// BFS through the component. The queue ends up holding the component.
+		for (unsigned int head=0; head<bfsQueue.size(); head++) {
+			Node v = bfsQueue[head];
+			for (set<Node>::const_iterator it = neighborSets[v].begin();
 				it != neighborSets[v].end(); ++it) {
 				Node u = *it;
 				if (visitedList[u] == 0) {
-					bfsQueue.push(u);
+					bfsQueue.push_back(u);
 					visitedList[u] = 1;
-					compProducer.insert(u);
-					numberOfUnhandeledNodes--;
 				}
-				else if (visitedList[u] == -1) {
-					sepProducer.insert(u);
+				else if (visitedList[u] == -1 && ws.separatorOf[u] != blockIndex) {
+					ws.separatorOf[u] = blockIndex;
+					separator.push_back(u);
 				}
 			}
 		}
-		blocks.push_back(BlockPtr(new Block(sepProducer.produce(), compProducer.produce(),getNumberOfNodes())));
+		ws.blocks.push_back(separator, bfsQueue);
 	}
-	return blocks;
 }
+// BFS over the bit-matrix: each step takes all unvisited neighbors of a node,
+// and all of its neighbors in the removed set, a word at a time.
+void Graph::getBlocksBitsetAux(BlocksWorkspace& ws, int prefixSize) const {
+	int words = BitMatrix::wordsFor(prefixSize);
+	vector<BitWord>& unvisited = ws.unvisitedWords;
+	vector<BitWord>& removed = ws.removedWords;
+	vector<BitWord>& sep = ws.sepWords;
+	vector<BitWord>& comp = ws.compWords;
+	vector<Node>& bfsQueue = ws.bfsQueue;
+	unvisited.assign(words, 0);
+	removed.assign(words, 0);
+	sep.resize(words);
+	comp.resize(words);
+	for (Node v=0; v<prefixSize; v++) {
+		if (ws.visited[v] == 0) {
+			unvisited[v/BITWORD_BITS] |= 1ULL << (v%BITWORD_BITS);
+		} else if (ws.visited[v] == -1) {
+			removed[v/BITWORD_BITS] |= 1ULL << (v%BITWORD_BITS);
+		}
+	}
+	for (int firstWord=0; firstWord<words; ) {
+		if (!unvisited[firstWord]) {
+			firstWord++;
+			continue;
+		}
+		std::fill(sep.begin(), sep.end(), 0ULL);
+		std::fill(comp.begin(), comp.end(), 0ULL);
+		BitWord first = unvisited[firstWord];
+		Node start = firstWord*BITWORD_BITS + BitMatrix::popLowestBit(first);
+		unvisited[firstWord] &= ~(1ULL << (start%BITWORD_BITS));
+		comp[firstWord] |= 1ULL << (start%BITWORD_BITS);
+		bfsQueue.clear();
+		bfsQueue.push_back(start);
+		for (unsigned int head=0; head<bfsQueue.size(); head++) {
+			const BitWord* row = adjacencyMatrix.row(bfsQueue[head]);
+			for (int w=0; w<words; ++w) {
+				sep[w] |= row[w] & removed[w];
+				BitWord reached = row[w] & unvisited[w];
+				if (!reached) {
+					continue;
+				}
+				unvisited[w] &= ~reached;
+				comp[w] |= reached;
+				while (reached) {
+					bfsQueue.push_back(w*BITWORD_BITS + BitMatrix::popLowestBit(reached));
+				}
+			}
+		}
+		ws.blocks.push_back(sep.data(), comp.data(), words);
+	}
+}
+
 string Graph::str() const {
     ostringstream oss;
 	for (Node v=0; v<getNumberOfNodes(); v++) {
@@ -12,6 +12,18 @@ using namespace std;
 
 namespace tdenum {
 
+/**
+ * Adjacency representations.
+ * ADJACENCY_SETS keeps a sorted neighbor set per node.
+ * ADJACENCY_BITSET also keeps a packed bit-matrix of the edges, so that
+ * areNeighbors() is O(1), and neighborhood unions, clique saturation and
+ * component searches are done a word (64 nodes) at a time.
+ * The bit-matrix costs n^2/8 bytes, so it is meant for graphs of up to a few
+ * thousand nodes.
+ */
+enum AdjacencyBackend { ADJACENCY_SETS, ADJACENCY_BITSET };
+#define GRAPH_BITSET_MAX_NODES 8192
+
 /**
  * When using node renaming methods (sorting, random rename..) note
  * that graph structures (PMCs, separators) also have their names changed!
@@ -27,6 +39,9 @@ class Graph {
 	int numberOfNodes;
 	int numberOfEdges;
 	vector< set<Node> > neighborSets;
+	AdjacencyBackend adjacency;
+	BitMatrix adjacencyMatrix; // Only maintained with ADJACENCY_BITSET
+	void rebuildAdjacencyMatrix();
 
 	// If the graph is randomized, update these
 	bool isRandomGraph;
@@ -41,8 +56,10 @@ class Graph {
 	void composeNewToOld(vector<Node> oldToNew);
 
 	bool isValidNode(Node v) const;
+	bool areValidNodes(const vector<Node>& nodes) const;
 	vector< vector<Node> > getComponentsAux(vector<int> visitedList, int numberOfUnhandeledNodes) const;
-	BlockVec getBlocksAux(vector<int> visitedList, int numberOfUnhandeledNodes) const;
+	void getBlocksAux(BlocksWorkspace& ws, int prefixSize) const;
+	void getBlocksBitsetAux(BlocksWorkspace& ws, int prefixSize) const;
 
 	// Used by node renaming / sorting methods.
 	// nodeRenameAux returns a mapping from old names to new.
@@ -65,11 +82,17 @@ public:
 	// Constructs an empty graph
 	Graph();
 	// Constructs a graph with nodes and without edges
-	Graph(int numberOfNodes);
+	Graph(int numberOfNodes, AdjacencyBackend a = ADJACENCY_SETS);
 	// Resets the graph (call constructor again)
 	Graph& reset(int numberOfNodes = 0);
 	// Removes all but the first k nodes from the graph/
 	Graph& removeAllButFirstK(int k);
+	// Switches the adjacency representation (edges are kept).
+	Graph& setAdjacency(AdjacencyBackend a);
+	AdjacencyBackend getAdjacency() const;
+	// Returns ADJACENCY_BITSET if the graph is small enough for the
+	// bit-matrix to pay off (see GRAPH_BITSET_MAX_NODES).
+	static AdjacencyBackend preferredAdjacency(int numberOfNodes);
 
 	// Given a graph with n vertices and no edges, creates a random graph
 	// from G(p,n).
@@ -92,6 +115,8 @@ public:
 	// If this is called, the current node names are treated as
 	// the original node names
 	Graph& forgetOriginalNames();
+	// Returns true if the current node names differ from the original names
+	bool isRenamed() const;
 
 	// Connects the given two nodes by a edge
 	Graph& addEdge(Node u, Node v);
@@ -132,6 +157,10 @@ public:
 	NodeSet getNeighbors(const set<Node>& s) const;
 	// Returns whether there is an edge between the given two nodes
 	bool areNeighbors(Node u, Node v) const;
+	// With ADJACENCY_BITSET, returns the neighbors of the node as a bit-packed
+	// row of getNumberOfNeighborWords() words
+	const BitWord* getNeighborWords(Node v) const { return adjacencyMatrix.row(v); }
+	int getNumberOfNeighborWords() const { return adjacencyMatrix.getWordsPerRow(); }
 	// Returns a map from the Nodes numbers to the number of the component they are in.
 	// -1 if they are in the input set.
 	vector<int> getComponentsMap(const vector<Node>& removedNodes) const;
@@ -150,6 +179,13 @@ public:
 	// Returns the set of blocks of the given node set
 	BlockVec getBlocks(const set<Node>& removedNodes) const;
 	BlockVec getBlocks(const NodeSet& removedNodes) const;
+	// Same, but the blocks are written flat into the given workspace, which
+	// can be reused between calls. The result is valid until the next call.
+	const FlatBlockVec& getBlocks(const NodeSet& removedNodes, BlocksWorkspace& ws) const;
+	// Same, in the subgraph induced by the nodes 0..prefixSize-1. The removed
+	// nodes must be among them.
+	const FlatBlockVec& getBlocks(const NodeSet& removedNodes, BlocksWorkspace& ws,
+			int prefixSize) const;
 	// Prints the graph
 	string str() const;
 	void print() const;
@@ -158,6 +194,11 @@ public:
 	bool operator!=(const Graph&) const;
 };
 
+/**
+ * A graph shared, read-only, by the engines working on it, so that they don't
+ * each keep a copy. Engines given a Graph by value move it into a new one.
+ */
+typedef shared_ptr<const Graph> GraphPtr;
 
 
 } /* namespace tdenum */
@@ -0,0 +1,212 @@
+#include "GraphReduction.h"
+#include <deque>
+
+namespace tdenum {
+
+/*
+ * The tree-width is at least the minimum degree of every subgraph, so it is
+ * at least the degeneracy, found by removing nodes of minimum degree.
+ */
+static int getDegeneracy(const vector< set<Node> >& neighbors) {
+	int n = neighbors.size();
+	vector<int> degree(n);
+	set< pair<int,Node> > byDegree;
+	for (Node v=0; v<n; v++) {
+		degree[v] = neighbors[v].size();
+		byDegree.insert(make_pair(degree[v], v));
+	}
+	vector<bool> removed(n, false);
+	int degeneracy = 0;
+	while (!byDegree.empty()) {
+		Node v = byDegree.begin()->second;
+		degeneracy = max(degeneracy, byDegree.begin()->first);
+		byDegree.erase(byDegree.begin());
+		removed[v] = true;
+		for (set<Node>::const_iterator it = neighbors[v].begin(); it != neighbors[v].end(); ++it) {
+			if (!removed[*it]) {
+				byDegree.erase(make_pair(degree[*it], *it));
+				degree[*it]--;
+				byDegree.insert(make_pair(degree[*it], *it));
+			}
+		}
+	}
+	return degeneracy;
+}
+
+/*
+ * Returns the nodes of the neighborhood of v that all its missing edges touch.
+ * If there are no missing edges v is simplicial, and if some node is returned
+ * v is almost simplicial (a single missing edge gives both its ends).
+ * Otherwise three -1s are returned.
+ */
+static NodeSet getNonSimplicialNeighbors(const vector< set<Node> >& neighbors, Node v) {
+	const set<Node>& vNeighbors = neighbors[v];
+	NodeSet missing;
+	for (set<Node>::const_iterator it = vNeighbors.begin(); it != vNeighbors.end(); ++it) {
+		set<Node>::const_iterator jt = it;
+		for (++jt; jt != vNeighbors.end(); ++jt) {
+			if (neighbors[*it].find(*jt) != neighbors[*it].end()) {
+				continue;
+			}
+			if (missing.empty()) {
+				missing.push_back(*it);
+				missing.push_back(*jt);
+			} else if (missing.size() == 2) {
+				// The missing edges so far share the node kept in missing
+				if (*it == missing[0] || *jt == missing[0]) {
+					missing.resize(1);
+				} else if (*it == missing[1] || *jt == missing[1]) {
+					missing.erase(missing.begin());
+				} else {
+					return NodeSet(3, -1);
+				}
+			} else if (*it != missing[0] && *jt != missing[0]) {
+				return NodeSet(3, -1);
+			}
+		}
+	}
+	return missing;
+}
+
+/*
+ * Initialization. Nodes are checked again whenever their neighborhood changes,
+ * until no rule applies.
+ */
+GraphReduction::GraphReduction(GraphPtr g, ReductionRules rules) :
+		graph(g), widthLowerBound(0) {
+	int n = graph->getNumberOfNodes();
+	vector< set<Node> > neighbors(n);
+	for (Node v=0; v<n; v++) {
+		neighbors[v] = graph->getNeighbors(v);
+	}
+	if (rules == WIDTH_RULES) {
+		widthLowerBound = getDegeneracy(neighbors);
+	}
+	vector<bool> removed(n, false);
+	vector<bool> queued(n, true);
+	deque<Node> toCheck;
+	for (Node v=0; v<n; v++) {
+		toCheck.push_back(v);
+	}
+	while (!toCheck.empty()) {
+		Node v = toCheck.front();
+		toCheck.pop_front();
+		queued[v] = false;
+		NodeSet missing = getNonSimplicialNeighbors(neighbors, v);
+		int degree = neighbors[v].size();
+		ReductionStep step;
+		step.node = v;
+		step.neighbors = NodeSet(neighbors[v].begin(), neighbors[v].end());
+		if (missing.empty()) {
+			widthLowerBound = max(widthLowerBound, degree);
+		} else if (rules == WIDTH_RULES && missing.size() <= 2 && degree <= widthLowerBound) {
+			// Make the neighborhood a clique; the others are adjacent to all
+			// but missing[0]
+			Node u = missing[0];
+			for (set<Node>::const_iterator it = neighbors[v].begin(); it != neighbors[v].end(); ++it) {
+				if (*it != u && neighbors[u].insert(*it).second) {
+					neighbors[*it].insert(u);
+					step.fillEdges.push_back(make_pair(u, *it));
+				}
+			}
+		} else {
+			continue;
+		}
+		log.push_back(step);
+		removed[v] = true;
+		for (set<Node>::const_iterator it = neighbors[v].begin(); it != neighbors[v].end(); ++it) {
+			neighbors[*it].erase(v);
+			if (!queued[*it]) {
+				queued[*it] = true;
+				toCheck.push_back(*it);
+			}
+		}
+		neighbors[v].clear();
+	}
+	vector<int> originalToReduced(n, -1);
+	for (Node v=0; v<n; v++) {
+		if (!removed[v]) {
+			originalToReduced[v] = reducedToOriginal.size();
+			reducedToOriginal.push_back(v);
+		}
+	}
+	reducedGraph.reset(reducedToOriginal.size());
+	for (unsigned int i=0; i<reducedToOriginal.size(); i++) {
+		const set<Node>& vNeighbors = neighbors[reducedToOriginal[i]];
+		for (set<Node>::const_iterator it = vNeighbors.begin(); it != vNeighbors.end(); ++it) {
+			if (originalToReduced[*it] > (int)i) {
+				reducedGraph.addEdge(i, originalToReduced[*it]);
+			}
+		}
+	}
+}
+
+const Graph& GraphReduction::getReducedGraph() const {
+	return reducedGraph;
+}
+
+int GraphReduction::getNumberOfRemovedNodes() const {
+	return log.size();
+}
+
+int GraphReduction::getWidthLowerBound() const {
+	return widthLowerBound;
+}
+
+bool GraphReduction::isExact() const {
+	for (unsigned int i=0; i<log.size(); i++) {
+		if (!log[i].fillEdges.empty()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * With the edges added by eliminations, the removed nodes are simplicial in
+ * the result when they are removed in the same order.
+ */
+ChordalGraph GraphReduction::liftTriangulation(const Graph& triangulation) const {
+	ChordalGraph lifted(*graph);
+	for (unsigned int i=0; i<log.size(); i++) {
+		for (unsigned int j=0; j<log[i].fillEdges.size(); j++) {
+			lifted.addEdge(log[i].fillEdges[j].first, log[i].fillEdges[j].second);
+		}
+	}
+	for (Node v=0; v<triangulation.getNumberOfNodes(); v++) {
+		const set<Node>& vNeighbors = triangulation.getNeighbors(v);
+		for (set<Node>::const_iterator it = vNeighbors.begin(); it != vNeighbors.end(); ++it) {
+			if (v < *it) {
+				lifted.addEdge(reducedToOriginal[v], reducedToOriginal[*it]);
+			}
+		}
+	}
+	return lifted;
+}
+
+/*
+ * The closed neighborhood of a simplicial node is a maximal clique of every
+ * minimal triangulation, and it absorbs its neighborhood if that was one. The
+ * steps are undone in reverse order.
+ */
+NodeSetSet GraphReduction::liftPotentialMaximalCliques(const NodeSetSet& pmcs) const {
+	NodeSetSet lifted;
+	for (NodeSetSet::iterator it = pmcs.begin(); it != pmcs.end(); ++it) {
+		NodeSet pmc;
+		for (unsigned int i=0; i<it->size(); i++) {
+			pmc.push_back(reducedToOriginal[(*it)[i]]);
+		}
+		lifted.insert(pmc);
+	}
+	for (int i=log.size()-1; i>=0; i--) {
+		const NodeSet& neighbors = log[i].neighbors;
+		lifted.remove(neighbors);
+		NodeSet closedNeighborhood = neighbors;
+		closedNeighborhood.insert(lower_bound(closedNeighborhood.begin(),
+				closedNeighborhood.end(), log[i].node), log[i].node);
+		lifted.insert(closedNeighborhood);
+	}
+	return lifted;
+}
+
+} /* namespace tdenum */
@@ -0,0 +1,65 @@
+#ifndef GRAPHREDUCTION_H_
+#define GRAPHREDUCTION_H_
+
+#include "Graph.h"
+#include "ChordalGraph.h"
+
+namespace tdenum {
+
+/**
+ * Which reduction rules are applied.
+ * SIMPLICIAL_RULE removes simplicial nodes. A simplicial node gets no fill
+ * edges in a minimal triangulation, so the minimal triangulations (and the
+ * potential maximal cliques) of the graph and of the reduced graph correspond
+ * one to one.
+ * WIDTH_RULES also eliminates almost simplicial nodes (including nodes of
+ * degree 2) whose degree is at most a lower bound on the tree-width, by making
+ * their neighborhood a clique. This keeps the tree-width only: an optimal width
+ * triangulation of the reduced graph is lifted to an optimal width
+ * triangulation of the graph, which may not be minimal.
+ * See:
+ * H. L. Bodlaender, A. M. C. A. Koster and F. van den Eijkhof.
+ * Preprocessing rules for triangulation of probabilistic networks, 2005.
+ */
+enum ReductionRules { SIMPLICIAL_RULE, WIDTH_RULES };
+
+/**
+ * Reduces a graph by the given rules, and keeps a log of the removed nodes to
+ * lift results on the reduced graph back to the graph.
+ * The remaining nodes are renamed 0..k-1, in their order in the graph.
+ */
+class GraphReduction {
+	// A removed node and its neighbors at the time, in the names of the graph
+	struct ReductionStep {
+		Node node;
+		NodeSet neighbors;
+		// If it was eliminated, the edges that made its neighbors a clique
+		vector< pair<Node,Node> > fillEdges;
+	};
+	GraphPtr graph;
+	Graph reducedGraph;
+	vector<Node> reducedToOriginal;
+	vector<ReductionStep> log;
+	int widthLowerBound;
+public:
+	GraphReduction(GraphPtr g, ReductionRules rules = SIMPLICIAL_RULE);
+	// Returns the reduced graph
+	const Graph& getReducedGraph() const;
+	// Returns the number of nodes removed
+	int getNumberOfRemovedNodes() const;
+	// Returns a lower bound on the tree-width of the graph, found while reducing
+	int getWidthLowerBound() const;
+	// Returns whether only simplicial nodes were removed, so the minimal
+	// triangulations and the potential maximal cliques are lifted exactly
+	bool isExact() const;
+	// Returns the triangulation of the graph given by a triangulation of the
+	// reduced graph
+	ChordalGraph liftTriangulation(const Graph& triangulation) const;
+	// Returns the potential maximal cliques of the graph given the ones of the
+	// reduced graph. Only valid if isExact().
+	NodeSetSet liftPotentialMaximalCliques(const NodeSetSet& pmcs) const;
+};
+
+} /* namespace tdenum */
+
+#endif /* GRAPHREDUCTION_H_ */
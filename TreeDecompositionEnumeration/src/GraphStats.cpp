@@ -323,7 +323,7 @@ GraphStats& GraphStats::set_p(double prob) { g.declareRandom(prob, get_instance(
 
 // Getters
 bool GraphStats::has_nodes() const { return get_n() > 0; }
-Graph GraphStats::get_graph() const { return g;}
+const Graph& GraphStats::get_graph() const { return g;}
 unsigned GraphStats::get_n() const { return g.getNumberOfNodes();}
 int GraphStats::get_m() const { return g.getNumberOfEdges();}
 double GraphStats::get_p() const { return g.getP(); }
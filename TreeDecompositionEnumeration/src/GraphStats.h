@@ -258,7 +258,7 @@ public:
     // If the value calculated is invalid because of timeout / count limit,
     // return the value calculated (may be invalid!)
     bool has_nodes() const;
-    Graph get_graph() const;
+    const Graph& get_graph() const;
     unsigned get_n() const;
     int get_m() const;
     int get_instance() const;
@@ -1,5 +1,8 @@
 #include "GraphTester.h"
 #include "Graph.h"
+#include "PrefixGraph.h"
+#include "SubGraph.h"
+#include <algorithm>
 
 namespace tdenum {
 
@@ -98,6 +101,137 @@ bool GraphTester::creating_random() const {
     return true;
 }
 
+bool GraphTester::bitset_adjacency() const {
+    // More than one word per row
+    int n=70;
+    SETUP(n);
+    for (double p=0.05; p<0.5; p+=0.1) {
+        g.randomize(p);
+        Graph b = g;
+        b.setAdjacency(ADJACENCY_BITSET);
+        ASSERT_EQ(b.getAdjacency(), ADJACENCY_BITSET);
+        for (Node u=0; u<n; ++u) {
+            for (Node v=0; v<n; ++v) {
+                ASSERT_EQ(g.areNeighbors(u,v), b.areNeighbors(u,v));
+            }
+        }
+        NodeSet removed({0,3,64,65,69});
+        ASSERT_EQ(g.getNeighbors(removed), b.getNeighbors(removed));
+        BlockVec gBlocks = g.getBlocks(removed);
+        BlockVec bBlocks = b.getBlocks(removed);
+        ASSERT_EQ(gBlocks.size(), bBlocks.size());
+        for (unsigned int i=0; i<gBlocks.size(); ++i) {
+            ASSERT_EQ(gBlocks[i]->S, bBlocks[i]->S);
+            ASSERT_EQ(gBlocks[i]->C, bBlocks[i]->C);
+        }
+        // Saturating a clique updates both representations
+        NodeSet clique({1,2,63,64,68});
+        g.addClique(clique);
+        b.addClique(clique);
+        ASSERT_EQ(g.getNumberOfEdges(), b.getNumberOfEdges());
+        b.setAdjacency(ADJACENCY_SETS);
+        ASSERT(g == b);
+    }
+    return true;
+}
+bool GraphTester::flat_blocks() const {
+    /**
+     *   0   4
+     *  / \
+     * 1---2--3
+     */
+    SETUP(5);
+    g.addClique(NodeSet({0,1,2}));
+    g.addEdge(2,3);
+    BlocksWorkspace ws;
+    // The same workspace is reused by all calls
+    for (int backend = ADJACENCY_SETS; backend <= ADJACENCY_BITSET; ++backend) {
+        g.setAdjacency(AdjacencyBackend(backend));
+        const FlatBlockVec& blocks = g.getBlocks(NodeSet({2}), ws);
+        ASSERT_EQ(blocks.size(), 3);
+        ASSERT(blocks.S(0) == NodeSet({2}));
+        ASSERT(blocks.C(0) == NodeSet({0,1}));
+        ASSERT(blocks.C(1) == NodeSet({3}));
+        ASSERT(blocks.S(2).empty());
+        ASSERT(blocks.C(2) == NodeSet({4}));
+        g.getBlocks(NodeSet({0,1,2,3}), ws);
+        ASSERT_EQ(ws.getBlocks().size(), 1);
+        ASSERT(ws.getBlocks().S(0).empty());
+        ASSERT(ws.getBlocks().C(0) == NodeSet({4}));
+    }
+    return true;
+}
+
+bool GraphTester::prefix_graph() const {
+    // More than one word per row, so some prefixes end inside a word
+    int n=70;
+    SETUP(n);
+    g.randomize(0.1);
+    BlocksWorkspace prefixWs, subWs;
+    for (int backend = ADJACENCY_SETS; backend <= ADJACENCY_BITSET; ++backend) {
+        g.setAdjacency(AdjacencyBackend(backend));
+        SubGraph main(g);
+        for (int size=0; size<=n; ++size) {
+            PrefixGraph prefix(g, size);
+            NodeSet first;
+            for (Node v=0; v<size; ++v) {
+                first.push_back(v);
+            }
+            SubGraph sub(main, first);
+            ASSERT_EQ(prefix.getNumberOfNodes(), sub.getNumberOfNodes());
+            for (Node u=0; u<size; ++u) {
+                ASSERT_EQ(prefix.d(u), sub.d(u));
+                for (Node v=0; v<size; ++v) {
+                    ASSERT_EQ(prefix.areNeighbors(u,v), sub.areNeighbors(u,v));
+                }
+            }
+            // No nodes, all of them, a closed neighborhood and random sets
+            vector<NodeSet> removedSets = {NodeSet(), first};
+            if (size > 0) {
+                NodeSet closed = {size-1};
+                for (Node u : g.getNeighbors(size-1)) {
+                    if (u < size) {
+                        closed.push_back(u);
+                    }
+                }
+                sort(closed.begin(), closed.end());
+                removedSets.push_back(closed);
+            }
+            for (int i=0; i<5; ++i) {
+                NodeSet removed;
+                for (Node v=0; v<size; ++v) {
+                    if (rand() % 6 == 0) {
+                        removed.push_back(v);
+                    }
+                }
+                removedSets.push_back(removed);
+            }
+            for (const NodeSet& removed : removedSets) {
+                vector<NodeSet> prefixComponents = prefix.getComponents(removed);
+                vector<NodeSet> subComponents = sub.getComponents(removed);
+                sort(prefixComponents.begin(), prefixComponents.end());
+                sort(subComponents.begin(), subComponents.end());
+                ASSERT(prefixComponents == subComponents);
+                for (const NodeSet& C : subComponents) {
+                    ASSERT_EQ(prefix.isFullComponent(C, removed),
+                              sub.isFullComponent(C, removed));
+                }
+                const FlatBlockVec& prefixBlocks = prefix.getBlocks(removed, prefixWs);
+                const FlatBlockVec& subBlocks = sub.getBlocks(removed, subWs);
+                ASSERT_EQ(prefixBlocks.size(), subBlocks.size());
+                set< pair<NodeSet,NodeSet> > prefixPairs, subPairs;
+                for (unsigned int i=0; i<subBlocks.size(); ++i) {
+                    prefixPairs.insert(make_pair(prefixBlocks.S(i).toNodeSet(),
+                                                 prefixBlocks.C(i).toNodeSet()));
+                    subPairs.insert(make_pair(subBlocks.S(i).toNodeSet(),
+                                              subBlocks.C(i).toNodeSet()));
+                }
+                ASSERT(prefixPairs == subPairs);
+            }
+        }
+    }
+    return true;
+}
 
 GraphTester::GraphTester() :
     TestInterface("Graph Tester")
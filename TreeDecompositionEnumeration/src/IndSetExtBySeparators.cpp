@@ -187,7 +187,12 @@ NodeSet IndSetExtBySeparators::mergeComponentAndNeighbors(
 
 }
 
-set<MinimalSeparator> IndSetExtBySeparators::extendToMaxIndependentSet(
+set<NodeSetId> IndSetExtBySeparators::extendToMaxIndependentSet(
+		const set<NodeSetId>& s) {
+	return separators.intern(extendSeparators(separators.get(s)));
+}
+
+set<MinimalSeparator> IndSetExtBySeparators::extendSeparators(
 		const set<MinimalSeparator>& minSeps) {
 
 	queue<SubGraph> Q;
@@ -195,7 +200,7 @@ set<MinimalSeparator> IndSetExtBySeparators::extendToMaxIndependentSet(
 	// create a copy of minSeps
 	set<MinimalSeparator> maximalSet = minSeps;
 
-	SubGraph sg = SubGraph(graph);
+	SubGraph sg = SubGraph(*graph);
 	if (maximalSet.empty()) {
 		Q.push(sg);
 	} else {
@@ -21,8 +21,9 @@ bool sortNodes(int node1, int node2);
 bool isInNodeSet(Node node, const NodeSet& nodes);
 
 
-class IndSetExtBySeparators: public IndependentSetExtender<MinimalSeparator> {
-	Graph graph;
+class IndSetExtBySeparators: public IndependentSetExtender<NodeSetId> {
+	GraphPtr graph;
+	NodeSetPool& separators;
 
 	vector<Node> getUnconnectedNodes(const Graph& graph);
 
@@ -36,22 +37,16 @@ class IndSetExtBySeparators: public IndependentSetExtender<MinimalSeparator> {
 			const NodeSet& compNeighbors);
 	queue<SubGraph> decompose(const SubGraph& mainSubGraph,
 		const set<MinimalSeparator>& s);
-	
+	set<MinimalSeparator> extendSeparators(const set<MinimalSeparator>& s);
 
 public:
-	IndSetExtBySeparators(const Graph& graph) :
-			graph(graph) {
+	IndSetExtBySeparators(GraphPtr graph, NodeSetPool& pool) :
+			graph(graph), separators(pool) {
 	}
 	;
 
-	IndSetExtBySeparators() {
-	}
-	;
-
-	
-
-	set<MinimalSeparator> extendToMaxIndependentSet(
-			const set<MinimalSeparator>& s) override;
+	set<NodeSetId> extendToMaxIndependentSet(
+			const set<NodeSetId>& s) override;
 };
 }
 
@@ -1,21 +1,64 @@
 #include "IndSetExtByTriangulation.h"
 #include "Converter.h"
 #include "MinimalTriangulator.h"
+#include <omp.h>
 
 namespace tdenum {
 
-IndSetExtByTriangulation::IndSetExtByTriangulation(const Graph& g, const MinimalTriangulator& t) :
-	graph(g), triangulator(t) {}
+IndSetExtByTriangulation::IndSetExtByTriangulation(GraphPtr g,
+		const MinimalTriangulator& t, NodeSetPool& pool) :
+	graph(g), triangulator(t), separators(pool), threads(1) {}
 
+void IndSetExtByTriangulation::setNumberOfThreads(int t) {
+	threads = t;
+}
+
+
+/*
+ * The views point to the shared graph, so they stay valid if this extender
+ * is copied.
+ */
+void IndSetExtByTriangulation::prepareOverlays(int threads) {
+	while ((int)overlays.size() < threads) {
+		overlays.push_back(OverlayGraph(*graph));
+	}
+}
+
+set<MinimalSeparator> IndSetExtByTriangulation::extendToMinimalSeparators(
+		const set<NodeSetId>& s, MinimalTriangulator& t, OverlayGraph& overlay) const {
+	// Saturate and triangulate a view of the graph, which only holds the
+	// added edges
+	overlay.clear();
+	for (set<NodeSetId>::const_iterator it = s.begin(); it != s.end(); ++it) {
+		overlay.addClique(separators.get(*it));
+	}
+	return t.triangulateToMinimalSeparators(overlay);
+}
+
+set<NodeSetId> IndSetExtByTriangulation::extendToMaxIndependentSet(
+		const set<NodeSetId>& s) {
+	prepareOverlays(1);
+	return separators.intern(extendToMinimalSeparators(s, triangulator, overlays[0]));
+}
 
-set<MinimalSeparator> IndSetExtByTriangulation::extendToMaxIndependentSet(
-		const set<MinimalSeparator>& s) {
-	Graph saturatedGraph(graph);
-	saturatedGraph.saturateNodeSets(s);
-	Graph minimalTriangulation = triangulator.triangulate(saturatedGraph);
-	set<MinimalSeparator> minimalSeparators =
-			Converter::triangulationToMinimalSeparators(minimalTriangulation);
-	return minimalSeparators;
+vector< set<NodeSetId> > IndSetExtByTriangulation::extendToMaxIndependentSets(
+		const vector< set<NodeSetId> >& sets) {
+	if (threadTriangulators.size() < (unsigned int)threads) {
+		threadTriangulators.resize(threads, triangulator);
+	}
+	prepareOverlays(threads);
+	vector< set<MinimalSeparator> > minimalSeparators(sets.size());
+	#pragma omp parallel for schedule(dynamic) num_threads(threads)
+	for (int i=0; i<(int)sets.size(); i++) {
+		minimalSeparators[i] = extendToMinimalSeparators(sets[i],
+				threadTriangulators[omp_get_thread_num()], overlays[omp_get_thread_num()]);
+	}
+	// Interning assigns IDs, so it is done in order once all threads are done
+	vector< set<NodeSetId> > results(sets.size());
+	for (unsigned int i=0; i<sets.size(); i++) {
+		results[i] = separators.intern(minimalSeparators[i]);
+	}
+	return results;
 }
 
 } /* namespace tdenum */
@@ -9,17 +9,33 @@ namespace tdenum {
 
 /**
  * An implementation of the IndependentSetExtender interface for the case where
- * the nodes are minimal separators.
+ * the nodes are minimal separators, given by their IDs in a NodeSetPool.
  * Uses a provided MinimalTriangulator to perform the steps of finding a minimal
- * triangulation.
+ * triangulation. Batches of sets are triangulated in parallel, each thread with
+ * its own copy of the triangulator.
  */
 class IndSetExtByTriangulation :
-		public IndependentSetExtender<MinimalSeparator>  {
-	Graph graph;
+		public IndependentSetExtender<NodeSetId>  {
+	GraphPtr graph;
 	MinimalTriangulator triangulator;
+	vector<MinimalTriangulator> threadTriangulators;
+	// Views of graph to saturate and triangulate, one per thread
+	vector<OverlayGraph> overlays;
+	NodeSetPool& separators;
+	int threads;
+	// Makes sure there are views of graph for the given number of threads
+	void prepareOverlays(int threads);
+	// Returns the minimal separators of a minimal triangulation of the graph
+	// saturated by s. Only reads the pool, so it may run concurrently.
+	set<MinimalSeparator> extendToMinimalSeparators(const set<NodeSetId>& s,
+			MinimalTriangulator& t, OverlayGraph& overlay) const;
 public:
-	IndSetExtByTriangulation(const Graph& g, const MinimalTriangulator& t);
-	virtual set<MinimalSeparator> extendToMaxIndependentSet(const set<MinimalSeparator>& s);
+	IndSetExtByTriangulation(GraphPtr g, const MinimalTriangulator& t, NodeSetPool& pool);
+	// Sets how many threads triangulate a batch (one by default)
+	void setNumberOfThreads(int threads);
+	virtual set<NodeSetId> extendToMaxIndependentSet(const set<NodeSetId>& s);
+	virtual vector< set<NodeSetId> > extendToMaxIndependentSets(
+			const vector< set<NodeSetId> >& sets);
 };
 
 } /* namespace tdenum */
@@ -4,34 +4,130 @@
 
 namespace tdenum {
 
-IndSetScorerByTriangulation::IndSetScorerByTriangulation(const Graph& g, TriangulationScoringCriterion c) :
-		graph(g), criterion(c) {}
+IndSetScorerByTriangulation::IndSetScorerByTriangulation(GraphPtr g,
+		TriangulationScoringCriterion c, const NodeSetPool& pool) :
+		graph(g), criterion(c), separators(pool), hasFillEdges(false) {
+	if (Graph::preferredAdjacency(graph->getNumberOfNodes()) == ADJACENCY_BITSET) {
+		saturated.reset(graph->getNumberOfNodes(), graph->getNumberOfNodes());
+		for (Node v=0; v<graph->getNumberOfNodes(); v++) {
+			for (set<Node>::const_iterator it = graph->getNeighbors(v).begin();
+					it != graph->getNeighbors(v).end(); ++it) {
+				saturated.set(v, *it);
+			}
+		}
+		if (criterion == DIFFERENECE) {
+			seenFillEdges.reset(graph->getNumberOfNodes(), graph->getNumberOfNodes());
+		}
+	}
+}
 
 IndSetScorerByTriangulation::~IndSetScorerByTriangulation() {}
 
-int IndSetScorerByTriangulation::scoreIndependentSet(const set<MinimalSeparator>& s) {
+/*
+ * Every pair of nodes of a separator that is not yet in the matrix is a fill
+ * edge. The fill edges of the previous set are cleared from the matrix first.
+ * Graphs too large for the matrix are saturated as a copy of the graph.
+ */
+void IndSetScorerByTriangulation::computeFillEdges(const set<NodeSetId>& s) {
+	if (hasFillEdges && fillEdgesOf == s) {
+		return;
+	}
+	if (saturated.getNumberOfRows() == graph->getNumberOfNodes()) {
+		for (vector< pair<Node,Node> >::iterator it = fillEdges.begin(); it != fillEdges.end(); ++it) {
+			saturated.clear(it->first, it->second);
+			saturated.clear(it->second, it->first);
+		}
+		fillEdges.clear();
+		for (set<NodeSetId>::const_iterator it = s.begin(); it != s.end(); ++it) {
+			const MinimalSeparator& separator = separators.get(*it);
+			for (unsigned int i=0; i<separator.size(); i++) {
+				for (unsigned int j=i+1; j<separator.size(); j++) {
+					if (!saturated.test(separator[i], separator[j])) {
+						saturated.set(separator[i], separator[j]);
+						saturated.set(separator[j], separator[i]);
+						fillEdges.push_back(make_pair(separator[i], separator[j]));
+					}
+				}
+			}
+		}
+	} else {
+		ChordalGraph triangulation = Converter::minimalSeparatorsToTriangulation(*graph, s, separators);
+		vector< set<Node> > edges = triangulation.getFillEdges(*graph);
+		fillEdges.clear();
+		for (vector< set<Node> >::iterator it = edges.begin(); it != edges.end(); ++it) {
+			fillEdges.push_back(make_pair(*it->begin(), *it->rbegin()));
+		}
+	}
+	fillEdgesOf = s;
+	hasFillEdges = true;
+}
+
+/*
+ * In a chordal graph, the visited neighbors of a node popped by Maximum
+ * Cardinality Search form a clique, and the largest of these is a maximum
+ * clique.
+ */
+int IndSetScorerByTriangulation::computeWidth() {
+	int n = graph->getNumberOfNodes();
+	fillNeighbors.resize(n);
+	for (Node v=0; v<n; v++) {
+		fillNeighbors[v].clear();
+	}
+	for (vector< pair<Node,Node> >::iterator it = fillEdges.begin(); it != fillEdges.end(); ++it) {
+		fillNeighbors[it->first].push_back(it->second);
+		fillNeighbors[it->second].push_back(it->first);
+	}
+	mcsQueue.reset(n);
+	visited.assign(n, false);
+	int width = -1;
+	while (!mcsQueue.isEmpty()) {
+		Node v = mcsQueue.pop();
+		visited[v] = true;
+		width = max(width, mcsQueue.getWeight(v));
+		for (set<Node>::const_iterator it = graph->getNeighbors(v).begin();
+				it != graph->getNeighbors(v).end(); ++it) {
+			if (!visited[*it]) {
+				mcsQueue.increaseWeight(*it);
+			}
+		}
+		for (vector<Node>::iterator it = fillNeighbors[v].begin(); it != fillNeighbors[v].end(); ++it) {
+			if (!visited[*it]) {
+				mcsQueue.increaseWeight(*it);
+			}
+		}
+	}
+	return width;
+}
+
+bool IndSetScorerByTriangulation::isSeen(const pair<Node,Node>& edge) const {
+	if (seenFillEdges.getNumberOfRows() > 0) {
+		return seenFillEdges.test(edge.first, edge.second);
+	}
+	return seenFillEdgesOfLargeGraph.find(edge) != seenFillEdgesOfLargeGraph.end();
+}
+
+int IndSetScorerByTriangulation::scoreIndependentSet(const set<NodeSetId>& s) {
 	if (criterion == NONE) {
 		return 0;
 	} else if (criterion == WIDTH) {
-		ChordalGraph g = Converter::minimalSeparatorsToTriangulation(graph, s);
-		return g.getTreeWidth();
+		computeFillEdges(s);
+		return computeWidth();
 	} else if (criterion == FILL) {
-		ChordalGraph g = Converter::minimalSeparatorsToTriangulation(graph, s);
-		return g.getFillIn(graph);
+		computeFillEdges(s);
+		return fillEdges.size();
 	} else if (criterion == MAX_SEP_SIZE) {
 		int maxSeparatorSize = 0;
-		for (set<MinimalSeparator>::iterator it = s.begin(); it!=s.end(); ++it) {
-			if (it->size() > (unsigned int)maxSeparatorSize) {
-				maxSeparatorSize = it->size();
+		for (set<NodeSetId>::iterator it = s.begin(); it!=s.end(); ++it) {
+			if (separators.get(*it).size() > (unsigned int)maxSeparatorSize) {
+				maxSeparatorSize = separators.get(*it).size();
 			}
 		}
 		return maxSeparatorSize;
 	} else if (criterion == DIFFERENECE) {
 		int score = 0;
-		ChordalGraph g = Converter::minimalSeparatorsToTriangulation(graph, s);
-		vector< set<Node> > fillEdges = g.getFillEdges(graph);
-		for (vector< set<Node> >::iterator it=fillEdges.begin(); it!=fillEdges.end(); ++it) {
-			if (seenFillEdges.find(*it) != seenFillEdges.end()) {
+		computeFillEdges(s);
+		for (vector< pair<Node,Node> >::iterator it=fillEdges.begin(); it!=fillEdges.end(); ++it) {
+			if (isSeen(*it)) {
 				score++;
 			}
 		}
@@ -44,12 +140,37 @@ bool IndSetScorerByTriangulation::mayScoreChange() {
 	return (criterion == DIFFERENECE);
 }
 
-void IndSetScorerByTriangulation::independentSetUsed(const set<MinimalSeparator>& s) {
+void IndSetScorerByTriangulation::independentSetUsed(const set<NodeSetId>& s) {
 	if (criterion == DIFFERENECE) {
-		ChordalGraph g = Converter::minimalSeparatorsToTriangulation(graph, s);
-		vector< set<Node> > fillEdges = g.getFillEdges(graph);
-		seenFillEdges.insert(fillEdges.begin(), fillEdges.end());
+		computeFillEdges(s);
+		for (vector< pair<Node,Node> >::iterator it=fillEdges.begin(); it!=fillEdges.end(); ++it) {
+			if (seenFillEdges.getNumberOfRows() > 0) {
+				seenFillEdges.set(it->first, it->second);
+			} else {
+				seenFillEdgesOfLargeGraph.insert(*it);
+			}
+		}
+	}
+}
+
+const vector< pair<Node,Node> >& IndSetScorerByTriangulation::getFillEdges(
+		const set<NodeSetId>& s) {
+	computeFillEdges(s);
+	return fillEdges;
+}
+
+int IndSetScorerByTriangulation::getTreeWidth(const set<NodeSetId>& s) {
+	computeFillEdges(s);
+	return computeWidth();
+}
+
+ChordalGraph IndSetScorerByTriangulation::getTriangulation(const set<NodeSetId>& s) {
+	computeFillEdges(s);
+	ChordalGraph triangulation(*graph);
+	for (vector< pair<Node,Node> >::iterator it=fillEdges.begin(); it!=fillEdges.end(); ++it) {
+		triangulation.addEdge(it->first, it->second);
 	}
+	return triangulation;
 }
 
 } /* namespace tdenum */
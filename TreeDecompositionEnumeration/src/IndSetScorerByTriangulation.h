@@ -2,7 +2,7 @@
 #define INDSETSCORERBYTRIANGULATION_H_
 
 #include "IndependentSetScorer.h"
-#include "Graph.h"
+#include "ChordalGraph.h"
 
 namespace tdenum {
 
@@ -10,21 +10,52 @@ enum TriangulationScoringCriterion { NONE, WIDTH, FILL, MAX_SEP_SIZE, DIFFERENEC
 
 /**
  * An implementation of the IndependentSetScorer interface for the case where
- * the nodes are minimal separators.
+ * the nodes are minimal separators, given by their IDs in a NodeSetPool.
  * Uses the conversion to a minimal triangulation to evaluate it.
  * Lower score is better.
+ *
+ * The fill edges are computed straight from the separators, by saturating them
+ * into a bit matrix of the graph's edges, and the width by a Maximum
+ * Cardinality Search over the graph and the fill edges. The fill edges of the
+ * last set are kept, so the triangulation of a set that was just scored is
+ * built without saturating it again.
  */
 class IndSetScorerByTriangulation :
-		public IndependentSetScorer<MinimalSeparator> {
-	Graph graph;
+		public IndependentSetScorer<NodeSetId> {
+	GraphPtr graph;
 	TriangulationScoringCriterion criterion;
-	set< set<Node> > seenFillEdges;
+	const NodeSetPool& separators;
+	// The fill edges of the used sets, as a bit matrix if the graph is small
+	// enough for one
+	BitMatrix seenFillEdges;
+	set< pair<Node,Node> > seenFillEdgesOfLargeGraph;
+	bool isSeen(const pair<Node,Node>& edge) const;
+	// Workspace
+	BitMatrix saturated; // The graph's edges, and the fill edges of fillEdgesOf
+	vector< pair<Node,Node> > fillEdges;
+	set<NodeSetId> fillEdgesOf;
+	bool hasFillEdges;
+	vector< vector<Node> > fillNeighbors;
+	IncreasingWeightNodeQueue mcsQueue;
+	vector<bool> visited;
+	// Computes the fill edges of the set, unless they are already known
+	void computeFillEdges(const set<NodeSetId>& s);
+	// Returns the width of the triangulation given by the graph and fillEdges
+	int computeWidth();
 public:
-	IndSetScorerByTriangulation(const Graph& g, TriangulationScoringCriterion c);
+	IndSetScorerByTriangulation(GraphPtr g, TriangulationScoringCriterion c,
+			const NodeSetPool& pool);
 	virtual ~IndSetScorerByTriangulation();
-	int scoreIndependentSet(const set<MinimalSeparator>& s);
+	int scoreIndependentSet(const set<NodeSetId>& s);
 	bool mayScoreChange();
-	void independentSetUsed(const set<MinimalSeparator>& s);
+	void independentSetUsed(const set<NodeSetId>& s);
+	// Returns the fill edges of the minimal triangulation given by the set.
+	// Valid until the next call to the scorer.
+	const vector< pair<Node,Node> >& getFillEdges(const set<NodeSetId>& s);
+	// Returns the width of the minimal triangulation given by the set
+	int getTreeWidth(const set<NodeSetId>& s);
+	// Returns the minimal triangulation given by the set
+	ChordalGraph getTriangulation(const set<NodeSetId>& s);
 };
 
 } /* namespace tdenum */
@@ -2,6 +2,7 @@
 #define INDEPENDENTSETEXTENDER_H_
 
 #include <set>
+#include <vector>
 using namespace std;
 
 namespace tdenum {
@@ -24,6 +25,17 @@ public:
 	 * contains it.
 	 */
 	virtual set<T> extendToMaxIndependentSet(const set<T>& s) = 0;
+	/**
+	 * Extends each of the given independent sets, the i'th result extending
+	 * the i'th set. Implementations may extend the sets concurrently.
+	 */
+	virtual vector< set<T> > extendToMaxIndependentSets(const vector< set<T> >& sets) {
+		vector< set<T> > results;
+		for (typename vector< set<T> >::const_iterator i=sets.begin(); i!=sets.end(); ++i) {
+			results.push_back(extendToMaxIndependentSet(*i));
+		}
+		return results;
+	}
 };
 
 } /* namespace tdenum */
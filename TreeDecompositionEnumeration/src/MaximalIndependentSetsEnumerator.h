@@ -4,16 +4,32 @@
 #include "SuccinctGraphRepresentation.h"
 #include "IndependentSetExtender.h"
 #include "IndependentSetScorer.h"
+#include "DataStructures.h"
+#include "CancellationToken.h"
+#include <unordered_map>
+#include <deque>
+#include <queue>
+#include <functional>
+#include <algorithm>
 
 namespace tdenum {
 
 enum AlgorithmStep {BEGINNING, ITERATING_NODES, ITERATING_SETS};
 
+// Upper bound on the number of nodes held by the extensions cache
+#define EXTENSIONS_CACHE_CAPACITY (1 << 22)
+
 /**
  * Enumerates the maximal independent sets of a graph given by a succinct graph
  * representation with an independent set expansion.
  * If the representation and the expansion are polynomial, this algorithm runs
  * in incremental polynomial delay.
+ *
+ * With an extension window larger than one, the extensions ahead of the
+ * current one are handed to the extender as a batch, which it may compute in
+ * parallel. The results are cached and consumed in the same order as without
+ * a window, so the sets are returned in the same order, as long as the result
+ * of an extension doesn't depend on the extensions computed before it.
  */
 template<class T>
 class MaximalIndependentSetsEnumerator {
@@ -27,7 +43,18 @@ class MaximalIndependentSetsEnumerator {
 	set<T> nodesGenerated;
 	set< set<T> > setsExtended;
 	set< set<T> > setsNotExtended;
-	set< pair<int, set<T> > > extendingQueue;
+	// A set waiting in setsNotExtended, with its score and the number of sets
+	// used when it was scored. Ties are broken by the sets themselves.
+	struct ScoredSet {
+		int score;
+		long long scoredAt;
+		typename set< set<T> >::iterator handle;
+		bool operator>(const ScoredSet& other) const {
+			return score != other.score ? score > other.score : *handle > *other.handle;
+		}
+	};
+	priority_queue< ScoredSet, vector<ScoredSet>, greater<ScoredSet> > extendingQueue;
+	long long setsUsed;
 	bool nextSetReady;
 	set<T> nextIndependentSet;
 	AlgorithmStep step;
@@ -37,14 +64,44 @@ class MaximalIndependentSetsEnumerator {
 	// State for case ITERATING_SETS
 	typename set< set<T> >::iterator setsIterator;
 	T currentNode;
+	// Extensions already computed, keyed by the fingerprint of their base set.
+	// Entries are evicted oldest first once they hold too many nodes.
+	struct CachedExtension {
+		set<T> baseNodes;
+		set<T> result;
+		bool prefetched; // computed in a batch and not looked up yet
+	};
+	unordered_map<NodeSetFingerprint, CachedExtension> extensionsCache;
+	deque<NodeSetFingerprint> extensionsCacheOrder;
+	long long extensionsCacheNodes;
+	long long cacheHits;
+	long long cacheMisses;
+	// How many extensions are computed together
+	int extensionWindow;
+	// Stops the enumeration when cancelled, if given
+	CancellationTokenPtr cancellation;
+	bool isCancelled() const { return cancellation && cancellation->isCancelled(); }
 
+	static NodeSetFingerprint fingerprintOf(const set<T>& nodes);
+	void cacheExtension(NodeSetFingerprint fingerprint, const set<T>& baseNodes,
+			const set<T>& result, bool prefetched);
+	set<T> extendToMaxIndependentSet(const set<T>& baseNodes);
+	void prefetchExtensions(const vector< set<T> >& baseSets);
+	void prefetchInDirectionsOfNodes(const set<T>& s, typename set<T>::iterator from);
+	void prefetchInDirectionOfNode(typename set< set<T> >::iterator from, const T& node);
 	void getNextSetToExtend();
+	set<T> getBaseSet(const set<T>& s, const T& node);
 	set<T> extendSetInDirectionOfNode(const set<T>& set, const T& node);
 	bool newSetFound(const set<T>& set);
+	bool extendCurrentSet();
+	bool extendSetsInDirectionOfCurrentNode();
+	bool generateNodesAndExtend();
 	bool runFullEnumeration();
 public:
 	MaximalIndependentSetsEnumerator(const MaximalIndependentSetsEnumerator& m) :
-		graph(m.graph), extender(m.extender), scorer(m.scorer){}
+		graph(m.graph), extender(m.extender), scorer(m.scorer),
+		setsUsed(0), extensionsCacheNodes(0), cacheHits(0), cacheMisses(0),
+		extensionWindow(m.extensionWindow), cancellation(m.cancellation) {}
 	MaximalIndependentSetsEnumerator& operator=(const MaximalIndependentSetsEnumerator& a){return *this;}
 	/**
 	 * Initialization. Receives a succinct graph representation with an
@@ -60,46 +117,207 @@ public:
 	 * Returns another maximal independent set.
 	 */
 	set<T> next();
+	/**
+	 * Returns how many extensions were answered from the cache, and how many
+	 * were passed on to the extender.
+	 */
+	long long getCacheHits() const { return cacheHits; }
+	long long getCacheMisses() const { return cacheMisses; }
+	/**
+	 * Sets how many extensions are passed to the extender at once. The default
+	 * of one extends the sets one at a time.
+	 */
+	void setExtensionWindow(int size) { extensionWindow = size; }
+	/**
+	 * Stops the enumeration once the token is cancelled: hasNext() returns
+	 * false from then on. The token is checked before every extension, which
+	 * costs far more than reading the clock.
+	 */
+	void setCancellationToken(CancellationTokenPtr token) { cancellation = token; }
 };
 
 
 
+template<class T>
+NodeSetFingerprint MaximalIndependentSetsEnumerator<T>::fingerprintOf(
+		const set<T>& nodes) {
+	NodeSetFingerprint fingerprint = 0;
+	for (typename set<T>::const_iterator i=nodes.begin(); i!=nodes.end(); ++i) {
+		fingerprint += nodeFingerprint(*i);
+	}
+	return fingerprint;
+}
+
+
+/*
+ * Saves an extension to the cache, replacing an entry of another base set with
+ * the same fingerprint, and evicts the oldest entries if the cache is full.
+ */
+template<class T>
+void MaximalIndependentSetsEnumerator<T>::cacheExtension(
+		NodeSetFingerprint fingerprint, const set<T>& baseNodes,
+		const set<T>& result, bool prefetched) {
+	typename unordered_map<NodeSetFingerprint, CachedExtension>::iterator
+			cached = extensionsCache.find(fingerprint);
+	if (cached != extensionsCache.end()) {
+		extensionsCacheNodes -= cached->second.baseNodes.size() + cached->second.result.size();
+	} else {
+		cached = extensionsCache.insert(make_pair(fingerprint, CachedExtension())).first;
+		extensionsCacheOrder.push_back(fingerprint);
+	}
+	cached->second.baseNodes = baseNodes;
+	cached->second.result = result;
+	cached->second.prefetched = prefetched;
+	extensionsCacheNodes += baseNodes.size() + result.size();
+	while (extensionsCacheNodes > EXTENSIONS_CACHE_CAPACITY && !extensionsCacheOrder.empty()) {
+		cached = extensionsCache.find(extensionsCacheOrder.front());
+		extensionsCacheNodes -= cached->second.baseNodes.size() + cached->second.result.size();
+		extensionsCache.erase(cached);
+		extensionsCacheOrder.pop_front();
+	}
+}
+
+
+/*
+ * Extends the given independent set, reusing the result if the same set was
+ * extended before. A fingerprint match is only trusted if the stored base set
+ * is equal to the given one. The first lookup of a prefetched extension counts
+ * as a miss, so the counters don't depend on the extension window.
+ */
+template<class T>
+set<T> MaximalIndependentSetsEnumerator<T>::extendToMaxIndependentSet(
+		const set<T>& baseNodes) {
+	NodeSetFingerprint fingerprint = fingerprintOf(baseNodes);
+	typename unordered_map<NodeSetFingerprint, CachedExtension>::iterator
+			cached = extensionsCache.find(fingerprint);
+	if (cached != extensionsCache.end() && cached->second.baseNodes == baseNodes) {
+		if (cached->second.prefetched) {
+			cached->second.prefetched = false;
+			cacheMisses++;
+		} else {
+			cacheHits++;
+		}
+		return cached->second.result;
+	}
+	cacheMisses++;
+	set<T> result = extender.extendToMaxIndependentSet(baseNodes);
+	cacheExtension(fingerprint, baseNodes, result, false);
+	return result;
+}
+
+
+/*
+ * Extends the base sets that are not cached yet as one batch, and caches the
+ * results.
+ */
+template<class T>
+void MaximalIndependentSetsEnumerator<T>::prefetchExtensions(
+		const vector< set<T> >& baseSets) {
+	vector< set<T> > batch;
+	vector<NodeSetFingerprint> fingerprints;
+	for (typename vector< set<T> >::const_iterator i=baseSets.begin(); i!=baseSets.end(); ++i) {
+		NodeSetFingerprint fingerprint = fingerprintOf(*i);
+		typename unordered_map<NodeSetFingerprint, CachedExtension>::iterator
+				cached = extensionsCache.find(fingerprint);
+		if ((cached == extensionsCache.end() || cached->second.baseNodes != *i)
+				&& find(fingerprints.begin(), fingerprints.end(), fingerprint) == fingerprints.end()) {
+			batch.push_back(*i);
+			fingerprints.push_back(fingerprint);
+		}
+	}
+	if (batch.size() < 2) {
+		// Nothing to gain over extending on demand
+		return;
+	}
+	vector< set<T> > results = extender.extendToMaxIndependentSets(batch);
+	for (unsigned int i=0; i<batch.size(); i++) {
+		cacheExtension(fingerprints[i], batch[i], results[i], true);
+	}
+}
+
+
+/*
+ * Prefetches the extensions of s in the directions of the next nodes, starting
+ * at from, unless the first of them is already cached.
+ */
+template<class T>
+void MaximalIndependentSetsEnumerator<T>::prefetchInDirectionsOfNodes(
+		const set<T>& s, typename set<T>::iterator from) {
+	vector< set<T> > baseSets;
+	for (; from != nodesGenerated.end() && (int)baseSets.size() < extensionWindow; ++from) {
+		if (s.find(*from) != s.end()) {
+			continue;
+		}
+		baseSets.push_back(getBaseSet(s, *from));
+		if (baseSets.size() == 1 && extensionsCache.find(fingerprintOf(baseSets[0])) != extensionsCache.end()) {
+			return;
+		}
+	}
+	prefetchExtensions(baseSets);
+}
+
+
+/*
+ * Prefetches the extensions of the next sets, starting at from, in the
+ * direction of the node, unless the first of them is already cached.
+ */
+template<class T>
+void MaximalIndependentSetsEnumerator<T>::prefetchInDirectionOfNode(
+		typename set< set<T> >::iterator from, const T& node) {
+	vector< set<T> > baseSets;
+	for (; from != setsExtended.end() && (int)baseSets.size() < extensionWindow; ++from) {
+		if (from->find(node) != from->end()) {
+			continue;
+		}
+		baseSets.push_back(getBaseSet(*from, node));
+		if (baseSets.size() == 1 && extensionsCache.find(fingerprintOf(baseSets[0])) != extensionsCache.end()) {
+			return;
+		}
+	}
+	prefetchExtensions(baseSets);
+}
+
+
 /**
  * Saves the next set to extend to currentSet.
  */
 template<class T>
 void MaximalIndependentSetsEnumerator<T>::getNextSetToExtend() {
-	pair<int, set<T> > currentScoredSet = *extendingQueue.begin();
+	ScoredSet currentScoredSet = extendingQueue.top();
+	extendingQueue.pop();
 	if (scorer.mayScoreChange()) {
-		// Support for changing scores: Maybe choose a different set if the score has changed
-		int currentScore = scorer.scoreIndependentSet(currentScoredSet.second);
-		while (currentScore > currentScoredSet.first) {
-			// Update weight
-			pair<int, set<T> > rescoredSet = make_pair(currentScore, currentScoredSet.second);
-			extendingQueue.erase(currentScoredSet);
-			extendingQueue.insert(rescoredSet);
-			// Choose new set
-			currentScoredSet = *extendingQueue.begin();
-			currentScore = scorer.scoreIndependentSet(currentScoredSet.second);
-		}
-	}
-	currentSet = currentScoredSet.second;
+		// Support for changing scores: Maybe choose a different set if the
+		// score has changed. Scores can only change when a set is used, so
+		// sets scored since the last one was used are not rescored.
+		while (currentScoredSet.scoredAt < setsUsed) {
+			int currentScore = scorer.scoreIndependentSet(*currentScoredSet.handle);
+			if (currentScore <= currentScoredSet.score) {
+				break;
+			}
+			// Update weight and choose new set
+			currentScoredSet.score = currentScore;
+			currentScoredSet.scoredAt = setsUsed;
+			extendingQueue.push(currentScoredSet);
+			currentScoredSet = extendingQueue.top();
+			extendingQueue.pop();
+		}
+	}
+	currentSet = *currentScoredSet.handle;
 	// Update that this set is being extended
 	scorer.independentSetUsed(currentSet);
+	setsUsed++;
 	setsExtended.insert(currentSet);
-	setsNotExtended.erase(currentSet);
-	extendingQueue.erase(currentScoredSet);
+	setsNotExtended.erase(currentScoredSet.handle);
 }
 
 
 /*
- * Input: maximal independent set and node.
- * Creates a maximal independent set containing the given node and the nodes
- * from the given set that do not share an edge with the given node.
+ * Input: independent set and node.
+ * Returns the node with the nodes from the given set that do not share an edge
+ * with it.
  */
 template<class T>
-set<T> MaximalIndependentSetsEnumerator<T>::extendSetInDirectionOfNode(
-		const set<T>& s, const T& node) {
+set<T> MaximalIndependentSetsEnumerator<T>::getBaseSet(const set<T>& s, const T& node) {
 	set<T> baseNodes;
 	baseNodes.insert(node);
 	for (typename set<T>::iterator i=s.begin(); i!=s.end(); ++i) {
@@ -107,7 +325,24 @@ set<T> MaximalIndependentSetsEnumerator<T>::extendSetInDirectionOfNode(
 			baseNodes.insert(*i);
 		}
 	}
-	return extender.extendToMaxIndependentSet(baseNodes);
+	return baseNodes;
+}
+
+
+/*
+ * Input: maximal independent set and node.
+ * Creates a maximal independent set containing the given node and the nodes
+ * from the given set that do not share an edge with the given node.
+ * A node that shares no edge with a maximal set is already in it, so in that
+ * case the result is the given set itself and the extender is not called.
+ */
+template<class T>
+set<T> MaximalIndependentSetsEnumerator<T>::extendSetInDirectionOfNode(
+		const set<T>& s, const T& node) {
+	if (s.find(node) != s.end()) {
+		return s;
+	}
+	return extendToMaxIndependentSet(getBaseSet(s, node));
 }
 
 
@@ -122,7 +357,11 @@ bool MaximalIndependentSetsEnumerator<T>::newSetFound(const set<T>& generatedSet
 	if (setsExtended.find(generatedSet) == setsExtended.end()) {
 		pair<typename set< set<T> >::iterator, bool> insertionReturnValue = setsNotExtended.insert(generatedSet);
 		if (insertionReturnValue.second) {
-			extendingQueue.insert(make_pair(scorer.scoreIndependentSet(generatedSet), generatedSet));
+			ScoredSet scoredSet;
+			scoredSet.score = scorer.scoreIndependentSet(generatedSet);
+			scoredSet.scoredAt = setsUsed;
+			scoredSet.handle = insertionReturnValue.first;
+			extendingQueue.push(scoredSet);
 			nextIndependentSet = generatedSet;
 			nextSetReady = true;
 			return true;
@@ -132,30 +371,73 @@ bool MaximalIndependentSetsEnumerator<T>::newSetFound(const set<T>& generatedSet
 }
 
 
+/*
+ * Extends currentSet in the directions of the nodes, continuing from
+ * nodesIterator. Returns whether a new set was found.
+ */
+template<class T>
+bool MaximalIndependentSetsEnumerator<T>::extendCurrentSet() {
+	for (; nodesIterator != nodesGenerated.end() && !isCancelled(); ++nodesIterator) {
+		if (extensionWindow > 1) {
+			prefetchInDirectionsOfNodes(currentSet, nodesIterator);
+		}
+		set<T> generatedSet = extendSetInDirectionOfNode(currentSet, *nodesIterator);
+		if (newSetFound(generatedSet)) {
+			step = ITERATING_NODES;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/*
+ * Extends the returned sets in the direction of currentNode, continuing from
+ * setsIterator. Returns whether a new set was found.
+ */
+template<class T>
+bool MaximalIndependentSetsEnumerator<T>::extendSetsInDirectionOfCurrentNode() {
+	for (; setsIterator != setsExtended.end() && !isCancelled(); ++setsIterator) {
+		if (extensionWindow > 1) {
+			prefetchInDirectionOfNode(setsIterator, currentNode);
+		}
+		set<T> generatedSet = extendSetInDirectionOfNode(*setsIterator, currentNode);
+		if (newSetFound(generatedSet)) {
+			step = ITERATING_SETS;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/*
+ * While there are no sets waiting to be extended, generates new nodes and
+ * extends the returned sets in their direction. Returns whether a new set was
+ * found.
+ */
+template<class T>
+bool MaximalIndependentSetsEnumerator<T>::generateNodesAndExtend() {
+	while(setsNotExtended.empty() && !isCancelled() && graph.hasNextNode()) {
+		// generate a new node and extend returned sets in this direction
+		currentNode = graph.nextNode();
+		nodesGenerated.insert(currentNode);
+		setsIterator = setsExtended.begin();
+		if (extendSetsInDirectionOfCurrentNode()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
 template<class T>
 bool MaximalIndependentSetsEnumerator<T>::runFullEnumeration() {
-	while (!extendingQueue.empty()) {
+	while (!extendingQueue.empty() && !isCancelled()) {
 		getNextSetToExtend();
-		for (nodesIterator = nodesGenerated.begin();
-				nodesIterator != nodesGenerated.end(); ++nodesIterator) {
-			set<T> generatedSet = extendSetInDirectionOfNode(currentSet, *nodesIterator);
-			if (newSetFound(generatedSet)) {
-				step = ITERATING_NODES;
-				return true;
-			}
-		}
-		while(setsNotExtended.empty() && graph.hasNextNode()) {
-			// generate a new node and extend returned sets in this direction
-			currentNode = graph.nextNode();
-			nodesGenerated.insert(currentNode);
-			for (setsIterator = setsExtended.begin();
-					setsIterator != setsExtended.end(); ++setsIterator) {
-				set<T> generatedSet = extendSetInDirectionOfNode(*setsIterator, currentNode);
-				if (newSetFound(generatedSet)) {
-					step = ITERATING_SETS;
-					return true;
-				}
-			}
+		nodesIterator = nodesGenerated.begin();
+		if (extendCurrentSet() || generateNodesAndExtend()) {
+			return true;
 		}
 	}
 	return false;
@@ -168,7 +450,8 @@ bool MaximalIndependentSetsEnumerator<T>::runFullEnumeration() {
 template<class T>
 MaximalIndependentSetsEnumerator<T>::MaximalIndependentSetsEnumerator(
 		SuccinctGraphRepresentation<T>& g, IndependentSetExtender<T>& e,
-		IndependentSetScorer<T>& s) : graph(g), extender(e), scorer (s) {
+		IndependentSetScorer<T>& s) : graph(g), extender(e), scorer (s),
+		setsUsed(0), extensionsCacheNodes(0), cacheHits(0), cacheMisses(0), extensionWindow(1) {
 	newSetFound(extender.extendToMaxIndependentSet(set<T>()));
 	step = BEGINNING;
 }
@@ -185,47 +468,10 @@ bool MaximalIndependentSetsEnumerator<T>::hasNext() {
 		if (step == BEGINNING) {
 			return runFullEnumeration();
 		} else if (step == ITERATING_NODES) {
-			for (; nodesIterator != nodesGenerated.end(); ++nodesIterator) {
-				set<T> generatedSet = extendSetInDirectionOfNode(currentSet, *nodesIterator);
-				if (newSetFound(generatedSet)) {
-					step = ITERATING_NODES;
-					return true;
-				}
-			}
-			while(setsNotExtended.empty() && graph.hasNextNode()) {
-				// generate a new node and extend returned sets in this direction
-				currentNode = graph.nextNode();
-				nodesGenerated.insert(currentNode);
-				for (setsIterator = setsExtended.begin(); setsIterator != setsExtended.end(); ++setsIterator) {
-					set<T> generatedSet = extendSetInDirectionOfNode(*setsIterator, currentNode);
-					if (newSetFound(generatedSet)) {
-						step = ITERATING_SETS;
-						return true;
-					}
-				}
-			}
-			return runFullEnumeration();
+			return extendCurrentSet() || generateNodesAndExtend() || runFullEnumeration();
 		} else if (step == ITERATING_SETS) {
-			for (; setsIterator != setsExtended.end(); ++setsIterator) {
-				set<T> generatedSet = extendSetInDirectionOfNode(*setsIterator, currentNode);
-				if (newSetFound(generatedSet)) {
-					step = ITERATING_SETS;
-					return true;
-				}
-			}
-			while(setsNotExtended.empty() && graph.hasNextNode()) {
-				// generate a new node and extend returned sets in this direction
-				currentNode = graph.nextNode();
-				nodesGenerated.insert(currentNode);
-				for (setsIterator = setsExtended.begin(); setsIterator != setsExtended.end(); ++setsIterator) {
-					set<T> generatedSet = extendSetInDirectionOfNode(*setsIterator, currentNode);
-					if (newSetFound(generatedSet)) {
-						step = ITERATING_SETS;
-						return true;
-					}
-				}
-			}
-			return runFullEnumeration();
+			return extendSetsInDirectionOfCurrentNode() || generateNodesAndExtend()
+					|| runFullEnumeration();
 		}
 	}
 	// We covered all cases so we should never get here
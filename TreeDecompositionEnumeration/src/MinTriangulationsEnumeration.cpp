@@ -1,11 +1,16 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
-#include <ctime>
 #include <cstdlib>
+#include <csignal>
 #include <string>
+#include <omp.h>
 #include "GraphReader.h"
 #include "MinimalTriangulationsEnumerator.h"
+#include "PartitionedTriangulationsEnumerator.h"
+#include "AtomsTriangulationsEnumerator.h"
+#include "GraphReduction.h"
+#include "PMCEnumerator.h"
 #include "MinTriangulationsEnumeration.h"
 #include "ResultsHandler.h"
 using namespace std;
@@ -57,7 +62,7 @@ void printSummaryHeader(ofstream& summaryOutput) {
 	ResultsHandler::printTableSummaryHeader(summaryOutput);
 }
 
-void printSummary(ofstream& summaryOutput, InputFile& input, Graph& graph, bool timeLimitExceeded,
+void printSummary(ofstream& summaryOutput, InputFile& input, const Graph& graph, bool timeLimitExceeded,
 		double time, string algorithm, int separators, ResultsHandler& results) {
 	string finished = timeLimitExceeded ? "No" : "Yes";
 	summaryOutput << input.getField() << ", " << input.getType() << ", " << input.getName()
@@ -67,16 +72,73 @@ void printSummary(ofstream& summaryOutput, InputFile& input, Graph& graph, bool
 	results.printTableSummary(summaryOutput);
 }
 
+/*
+ * Passes the triangulations of the enumerator to the results handler until
+ * they run out or the token is cancelled (the enumerator also stops then).
+ * Returns whether it was cancelled. If the enumerator runs on a reduced graph,
+ * the triangulations are lifted back to the graph.
+ */
+template<class Enumerator>
+bool runEnumeration(Enumerator& enumerator, const GraphReduction* reduction,
+		ResultsHandler& results, CancellationTokenPtr cancellation) {
+	enumerator.setCancellationToken(cancellation);
+	while (enumerator.hasNext()) {
+		ChordalGraph triangulation = enumerator.next();
+		if (reduction != NULL) {
+			triangulation = reduction->liftTriangulation(triangulation);
+		}
+		results.newResult(triangulation);
+		if (cancellation->isCancelled()) {
+			return true;
+		}
+	}
+	return cancellation->isCancelled();
+}
+
+/*
+ * Returns the potential maximal cliques of the graph, found on its atoms if
+ * asked for. If the reduction is exact, they are found on the reduced graph
+ * and lifted back. Returns whether they were all found before the token was
+ * cancelled.
+ */
+bool getPotentialMaximalCliques(GraphPtr graph, const GraphReduction* reduction,
+		bool byAtoms, CancellationTokenPtr cancellation, NodeSetSet& pmcs) {
+	bool lift = reduction != NULL && reduction->isExact();
+	GraphPtr input = lift ? make_shared<const Graph>(reduction->getReducedGraph()) : graph;
+	if (byAtoms) {
+		pmcs = getPotentialMaximalCliquesByAtoms(input, PMCAlg(), cancellation);
+	} else {
+		PMCEnumerator pmce(input);
+		pmce.set_cancellation_token(cancellation);
+		pmcs = pmce.get();
+	}
+	if (lift) {
+		pmcs = reduction->liftPotentialMaximalCliques(pmcs);
+	}
+	return !cancellation->isCancelled();
+}
+
 }
 
 using namespace tdenum;
 
 /**
- * First parameter is the graph file path. Second is timeout in seconds.
+ * First parameter is the graph file path. Second is timeout in seconds, which
+ * may be fractional. SIGTERM and SIGINT stop the enumeration like a timeout.
  * Third is the order of extending triangulations. Options are: width, fill,
  * difference, sepsize, none.
  * Fourth is the order of extending minimal separators. Options are: size
  * (ascending), fill or none.
+ * threads=<n> lets up to n independent set extensions run in parallel.
+ * partition=on splits the triangulations into disjoint parts, which are
+ * enumerated in parallel.
+ * atoms=on decomposes the graph by its clique minimal separators, and
+ * enumerates the triangulations of the atoms in parallel.
+ * reduce=on removes the simplicial nodes before the enumeration. reduce=width
+ * also eliminates almost simplicial nodes of small degree, which keeps only the
+ * tree-width: the triangulations may not be minimal.
+ * pmcs=on also counts the potential maximal cliques of the graph, on the atoms
+ * and the reduced graph if asked for.
  */
 int main(int argc, char* argv[]) {
 	// Parse input graph file
@@ -85,11 +147,18 @@ int main(int argc, char* argv[]) {
 		return 0;
 	}
 	InputFile inputFile(argv[1]);
-	Graph g = GraphReader::read(inputFile.getPath());
+	GraphPtr graph = make_shared<const Graph>(GraphReader::read(inputFile.getPath()));
+	const Graph& g = *graph;
 
 	// Define default parameters
 	bool isTimeLimited = false;
-	int timeLimitInSeconds = -1;
+	double timeLimitInSeconds = -1;
+	int threads = 1;
+	bool partitioned = false;
+	bool byAtoms = false;
+	bool reduced = false;
+	ReductionRules reductionRules = SIMPLICIAL_RULE;
+	bool countPMCs = false;
 	WhenToPrint print = NEVER;
 	string algorithm = "";
 	TriangulationAlgorithm heuristic = MCS_M;
@@ -102,10 +171,21 @@ int main(int argc, char* argv[]) {
 		string flagName = argument.substr(0, argument.find_last_of("="));
 		string flagValue = argument.substr(argument.find_last_of("=")+1);
 		if (flagName == "time_limit") {
-			timeLimitInSeconds = atoi(flagValue.c_str());
+			timeLimitInSeconds = atof(flagValue.c_str());
 			if (timeLimitInSeconds >= 0) {
 				isTimeLimited = true;
 			}
+		} else if (flagName == "threads") {
+			threads = atoi(flagValue.c_str());
+		} else if (flagName == "partition") {
+			partitioned = flagValue == "on";
+		} else if (flagName == "atoms") {
+			byAtoms = flagValue == "on";
+		} else if (flagName == "reduce") {
+			reduced = flagValue == "on" || flagValue == "width";
+			reductionRules = flagValue == "width" ? WIDTH_RULES : SIMPLICIAL_RULE;
+		} else if (flagName == "pmcs") {
+			countPMCs = flagValue == "on";
 		} else if (flagName == "print") {
 			if (flagValue == "all") {
 				print = ALWAYS;
@@ -188,28 +268,65 @@ int main(int argc, char* argv[]) {
 	cout << setprecision(2);
 	cout << "Starting enumeration for " << inputFile.getField() << "\\"
 			<< inputFile.getType() << "\\" << inputFile.getName() << endl;
-	clock_t startTime = clock();
+	CancellationTokenPtr cancellation = make_shared<CancellationToken>();
+	if (isTimeLimited) {
+		cancellation->setTimeLimit(timeLimitInSeconds);
+	}
+	cancellation->cancelOnSignal(SIGTERM);
+	cancellation->cancelOnSignal(SIGINT);
 	ResultsHandler results(g, detailedOutput, print);
 	bool timeLimitExceeded = false;
+	int separators = 0;
+	long long extensionsComputed = 0, extensionsReused = 0;
+	shared_ptr<GraphReduction> reduction;
+	if (reduced) {
+		reduction = make_shared<GraphReduction>(graph, reductionRules);
+		cout << reduction->getNumberOfRemovedNodes() << " nodes were removed." << endl;
+		if (reductionRules == WIDTH_RULES) {
+			cout << "The tree-width is at least " << reduction->getWidthLowerBound() << "." << endl;
+		}
+	}
+	const Graph& input = reduction ? reduction->getReducedGraph() : g;
 
 	// Generate the results and print details if asked for
-	MinimalTriangulationsEnumerator enumerator(g, triangulationsOrder, separatorsOrder, heuristic);
-	while (enumerator.hasNext()) {
-		ChordalGraph triangulation = enumerator.next();
-		results.newResult(triangulation);
-		double totalTimeInSeconds = double(clock() - startTime) / CLOCKS_PER_SEC;
-		if (isTimeLimited && totalTimeInSeconds >= timeLimitInSeconds) {
-			timeLimitExceeded = true;
-			break;
+	if (partitioned) {
+		PartitionedTriangulationsEnumerator enumerator(input, triangulationsOrder, separatorsOrder,
+				heuristic, cancellation);
+		if (threads > 1) {
+			enumerator.setNumberOfThreads(threads);
+		}
+		timeLimitExceeded = runEnumeration(enumerator, reduction.get(), results, cancellation);
+		cout << "The search was split into " << enumerator.getNumberOfParts() << " parts." << endl;
+		separators = enumerator.getNumberOfMinimalSeperatorsGenerated();
+		extensionsComputed = enumerator.getNumberOfExtensionsComputed();
+		extensionsReused = enumerator.getNumberOfExtensionsReused();
+	} else if (byAtoms) {
+		if (threads > 1) {
+			omp_set_num_threads(threads);
+		}
+		AtomsTriangulationsEnumerator enumerator(input, triangulationsOrder, separatorsOrder,
+				heuristic, cancellation);
+		timeLimitExceeded = runEnumeration(enumerator, reduction.get(), results, cancellation);
+		cout << "The graph was decomposed into " << enumerator.getNumberOfAtoms() << " atoms." << endl;
+		separators = enumerator.getNumberOfMinimalSeperatorsGenerated();
+		extensionsComputed = enumerator.getNumberOfExtensionsComputed();
+		extensionsReused = enumerator.getNumberOfExtensionsReused();
+	} else {
+		MinimalTriangulationsEnumerator enumerator(input, triangulationsOrder, separatorsOrder, heuristic);
+		if (threads > 1) {
+			enumerator.setNumberOfThreads(threads);
 		}
+		timeLimitExceeded = runEnumeration(enumerator, reduction.get(), results, cancellation);
+		separators = enumerator.getNumberOfMinimalSeperatorsGenerated();
+		extensionsComputed = enumerator.getNumberOfExtensionsComputed();
+		extensionsReused = enumerator.getNumberOfExtensionsReused();
 	}
 	if (print != NEVER) {
 		detailedOutput.close();
 	}
 
 	// Print summary to file
-	double totalTimeInSeconds = double(clock() - startTime) / CLOCKS_PER_SEC;
-	int separators = enumerator.getNumberOfMinimalSeperatorsGenerated();
+	double totalTimeInSeconds = cancellation->getElapsedSeconds();
 	printSummary(summaryOutput, inputFile, g, timeLimitExceeded,
 			totalTimeInSeconds, algorithm, separators, results);
 	summaryOutput.close();
@@ -217,12 +334,24 @@ int main(int argc, char* argv[]) {
 	// Print summary to standard output
 	if (timeLimitExceeded) {
 		cout << "Time limit reached." << endl;
+	} else if (reduction && !reduction->isExact()) {
+		cout << "All triangulations lifted from the reduced graph were generated!" << endl;
 	} else {
 		cout << "All minimal triangulations were generated!" << endl;
 	}
 	results.printReadableSummary(cout);
 	cout << "The graph has " << g.getNumberOfNodes() << " nodes and " << g.getNumberOfEdges() << " edges. ";
 	cout << separators << " minimal separators were generated in the process." << endl;
+	cout << extensionsComputed << " independent set extensions were computed and "
+			<< extensionsReused << " were reused." << endl;
+	if (countPMCs && !cancellation->isCancelled()) {
+		NodeSetSet pmcs;
+		if (getPotentialMaximalCliques(graph, reduction.get(), byAtoms, cancellation, pmcs)) {
+			cout << "The graph has " << pmcs.size() << " potential maximal cliques." << endl;
+		} else {
+			cout << "Time limit reached before all potential maximal cliques were found." << endl;
+		}
+	}
 
 	return 0;
 }
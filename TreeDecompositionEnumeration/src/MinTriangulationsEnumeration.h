@@ -24,7 +24,7 @@ public:
 
 void printSummaryHeader(ofstream& summaryOutput);
 
-void printSummary(ofstream& summaryOutput, InputFile& input, Graph& graph, bool timeLimitExceeded,
+void printSummary(ofstream& summaryOutput, InputFile& input, const Graph& graph, bool timeLimitExceeded,
 		double time, string algorithm, int separators, ResultsHandler& results);
 
 
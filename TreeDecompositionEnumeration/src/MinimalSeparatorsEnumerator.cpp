@@ -1,22 +1,44 @@
 #include "MinimalSeparatorsEnumerator.h"
 #include <ctime>
+#include <algorithm>
+#include <iterator>
 
 namespace tdenum {
 
+/*
+ * The graph is searched with the adjacency backend that suits its size
+ */
+static GraphPtr withPreferredAdjacency(Graph g) {
+	g.setAdjacency(Graph::preferredAdjacency(g.getNumberOfNodes()));
+	return make_shared<const Graph>(move(g));
+}
+
+static GraphPtr withPreferredAdjacency(GraphPtr g) {
+	if (g->getAdjacency() == Graph::preferredAdjacency(g->getNumberOfNodes())) {
+		return g;
+	}
+	return withPreferredAdjacency(*g);
+}
+
 /*
  * Initialization
  */
-MinimalSeparatorsEnumerator::MinimalSeparatorsEnumerator(const Graph& g, SeparatorsScoringCriterion c) :
-	graph(g), scorer(g,c) {
+MinimalSeparatorsEnumerator::MinimalSeparatorsEnumerator(Graph g, SeparatorsScoringCriterion c) :
+	MinimalSeparatorsEnumerator(withPreferredAdjacency(move(g)), c) {}
+
+MinimalSeparatorsEnumerator::MinimalSeparatorsEnumerator(GraphPtr g, SeparatorsScoringCriterion c) :
+	graph(withPreferredAdjacency(g)), scorer(graph,c) {
 	// Initialize separatorsNotReturned according to the initialization phase
-	for (Node v = 0; v < g.getNumberOfNodes(); v++) {
-		set<Node> vAndNeighbors = graph.getNeighbors(v);
+	for (Node v = 0; v < graph->getNumberOfNodes(); v++) {
+		set<Node> vAndNeighbors = graph->getNeighbors(v);
 		vAndNeighbors.insert(v);
-		BlockVec blocks = graph.getBlocks(vAndNeighbors);
-		for (auto it=blocks.begin(); it!=blocks.end(); ++it) {
-			if ((*it)->S.size() > 0) {
-				int score = scorer.scoreSeparator((*it)->S);
-				separatorsToExtend.insert((*it)->S, score);
+		const FlatBlockVec& blocks = graph->getBlocks(
+				NodeSet(vAndNeighbors.begin(), vAndNeighbors.end()), blocksWorkspace);
+		for (unsigned int i=0; i<blocks.size(); ++i) {
+			if (!blocks.S(i).empty()) {
+				NodeSet S = blocks.S(i).toNodeSet();
+				int score = scorer.scoreSeparator(S);
+				separatorsToExtend.insert(S, score);
 			}
 		}
 	}
@@ -56,21 +78,32 @@ MinimalSeparator MinimalSeparatorsEnumerator::next() {
 	// Process separator according to the generation phase
 	for (MinimalSeparator::iterator i = s.begin(); i != s.end(); ++i) {
 		Node x = *i;
-		set<Node> xNeighborsAndS = graph.getNeighbors(x);
-		xNeighborsAndS.insert(s.begin(),s.end());
-		BlockVec blocks = graph.getBlocks(xNeighborsAndS);
-		for (auto j = blocks.begin(); j != blocks.end(); ++j) {
-			minimalSeparatorFound((*j)->S);
+		const set<Node>& xNeighbors = graph->getNeighbors(x);
+		NodeSet xNeighborsAndS;
+		set_union(xNeighbors.begin(), xNeighbors.end(), s.begin(), s.end(),
+				back_inserter(xNeighborsAndS));
+		const FlatBlockVec& blocks = graph->getBlocks(xNeighborsAndS, blocksWorkspace);
+		for (unsigned int j=0; j<blocks.size(); ++j) {
+			if (!blocks.S(j).empty()) {
+				minimalSeparatorFound(blocks.S(j).toNodeSet());
+			}
 		}
 	}
 	return s;
 }
 
-bool MinimalSeparatorsEnumerator::getAll(NodeSetSet& out, time_t limit) {
-    time_t t = time(NULL);
+bool MinimalSeparatorsEnumerator::getAll(NodeSetSet& out, double limit) {
+    CancellationToken token;
+    if (limit > 0) {
+        token.setTimeLimit(limit);
+    }
+    return getAll(out, token);
+}
+
+bool MinimalSeparatorsEnumerator::getAll(NodeSetSet& out, const CancellationToken& token) {
     while (hasNext()) {
         out.insert(next());
-        if (limit > 0 && difftime(time(NULL),t) > limit) {
+        if (token.isCancelled()) {
             out = NodeSetSet();
             return false;
         }
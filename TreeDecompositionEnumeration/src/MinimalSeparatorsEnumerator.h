@@ -4,6 +4,7 @@
 #include "Graph.h"
 #include "SeparatorsScorer.h"
 #include "DataStructures.h"
+#include "CancellationToken.h"
 
 namespace tdenum {
 
@@ -15,22 +16,27 @@ namespace tdenum {
  * A. Berry, J. P. Bordat, and O. Cogis, 1999.
  */
 class MinimalSeparatorsEnumerator {
-	Graph graph;
+	GraphPtr graph;
 	SeparatorsScorer scorer;
 	WeightedNodeSetQueue separatorsToExtend;
 	NodeSetSet separatorsExtended;
+	BlocksWorkspace blocksWorkspace; // Reused by all calls to getBlocks
 	void minimalSeparatorFound(const MinimalSeparator& s);
 public:
 	// Initialization
-	MinimalSeparatorsEnumerator(const Graph& g, SeparatorsScoringCriterion c);
+	MinimalSeparatorsEnumerator(Graph g, SeparatorsScoringCriterion c);
+	// Shares g, unless it has to be copied to switch its adjacency backend
+	MinimalSeparatorsEnumerator(GraphPtr g, SeparatorsScoringCriterion c);
 	// Checks whether there is another minimal separator
 	bool hasNext();
 	// Returns another minimal separator
 	MinimalSeparator next();
 	// Returns all minimal separators as a NodeSetSet.
-	// If a non-zero time limit is given and the algorithm takes too long,
-	// returns false and sets the output to an empty NodeSetSet.
-	bool getAll(NodeSetSet& out, time_t limit = 0);
+	// If a non-zero time limit (in seconds) is given and the algorithm takes
+	// too long, returns false and sets the output to an empty NodeSetSet.
+	bool getAll(NodeSetSet& out, double limit = 0);
+	// Same, stopping when the token is cancelled
+	bool getAll(NodeSetSet& out, const CancellationToken& token);
 };
 
 } /* namespace tdenum */
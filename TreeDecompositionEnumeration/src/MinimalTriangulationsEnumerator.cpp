@@ -1,19 +1,69 @@
 #include "MinimalTriangulationsEnumerator.h"
-#include "Converter.h"
 
 namespace tdenum {
 
+TriangulationHandle::TriangulationHandle(IndSetScorerByTriangulation& s,
+		const NodeSetPool& pool, const set<NodeSetId>& ids) :
+		scorer(&s), separators(&pool), separatorIds(ids), hasFillEdges(false), width(-1) {}
+
+const set<NodeSetId>& TriangulationHandle::getSeparatorIds() const {
+	return separatorIds;
+}
+
+set<MinimalSeparator> TriangulationHandle::getSeparators() const {
+	return separators->get(separatorIds);
+}
+
+const vector< pair<Node,Node> >& TriangulationHandle::getFillEdges() {
+	if (!hasFillEdges) {
+		fillEdges = scorer->getFillEdges(separatorIds);
+		hasFillEdges = true;
+	}
+	return fillEdges;
+}
+
+int TriangulationHandle::getFillIn() {
+	return getFillEdges().size();
+}
+
+int TriangulationHandle::getTreeWidth() {
+	if (width == -1) {
+		width = scorer->getTreeWidth(separatorIds);
+	}
+	return width;
+}
+
+ChordalGraph TriangulationHandle::getTriangulation() {
+	return scorer->getTriangulation(separatorIds);
+}
+
+/*
+ * The graph gets the backend the separators enumerator searches it with, so
+ * that it doesn't make its own copy
+ */
+static GraphPtr withPreferredAdjacency(Graph g) {
+	g.setAdjacency(Graph::preferredAdjacency(g.getNumberOfNodes()));
+	return make_shared<const Graph>(move(g));
+}
+
 /*
  * Initialization
  */
 MinimalTriangulationsEnumerator::MinimalTriangulationsEnumerator(
-			const Graph& g, TriangulationScoringCriterion triC,
+			Graph g, TriangulationScoringCriterion triC,
 			SeparatorsScoringCriterion sepC, TriangulationAlgorithm heuristic) :
-		graph(g), separatorGraph(graph, sepC), triangulator(heuristic),
-		triExtender(graph, triangulator), sepExtender(graph), scorer(graph, triC),
-		setsEnumerator(separatorGraph, triExtender, scorer) {
+		MinimalTriangulationsEnumerator(withPreferredAdjacency(move(g)),
+				triC, sepC, heuristic) {}
+
+MinimalTriangulationsEnumerator::MinimalTriangulationsEnumerator(
+			GraphPtr g, TriangulationScoringCriterion triC,
+			SeparatorsScoringCriterion sepC, TriangulationAlgorithm heuristic) :
+		graph(g), heuristic(heuristic), separators(), separatorGraph(graph, sepC, separators),
+		triangulator(heuristic), triExtender(graph, triangulator, separators),
+		sepExtender(graph, separators), scorer(graph, triC, separators),
+		setsEnumerator(separatorGraph, triExtender, scorer), hasNextSet(false) {
 	if (heuristic == SEPARATORS) {
-		setsEnumerator = MaximalIndependentSetsEnumerator<MinimalSeparator>(
+		setsEnumerator = MaximalIndependentSetsEnumerator<NodeSetId>(
 				separatorGraph, sepExtender, scorer);
 	}
 }
@@ -22,20 +72,82 @@ MinimalTriangulationsEnumerator::MinimalTriangulationsEnumerator(
  * Checks whether there is another minimal triangulation
  */
 bool MinimalTriangulationsEnumerator::hasNext(){
-	return setsEnumerator.hasNext();
+	if (excludedSeparators.empty()) {
+		return setsEnumerator.hasNext();
+	}
+	while (!hasNextSet && setsEnumerator.hasNext()) {
+		nextSet = setsEnumerator.next();
+		hasNextSet = true;
+		for (set<NodeSetId>::const_iterator it = nextSet.begin(); it != nextSet.end(); ++it) {
+			if (excludedSeparators.count(*it)) {
+				hasNextSet = false;
+				break;
+			}
+		}
+	}
+	return hasNextSet;
+}
+
+set<NodeSetId> MinimalTriangulationsEnumerator::nextSeparators() {
+	if (excludedSeparators.empty()) {
+		return setsEnumerator.next();
+	}
+	if (!hasNext()) {
+		return set<NodeSetId>();
+	}
+	hasNextSet = false;
+	return nextSet;
 }
 
 /*
  * Returns another minimal triangulation
  */
 ChordalGraph MinimalTriangulationsEnumerator::next() {
-	return Converter::minimalSeparatorsToTriangulation(graph, setsEnumerator.next());
+	// The scorer has usually just scored this set, and reuses its fill edges
+	return scorer.getTriangulation(nextSeparators());
+}
+
+/*
+ * Returns another minimal triangulation, without building it
+ */
+TriangulationHandle MinimalTriangulationsEnumerator::nextHandle() {
+	return TriangulationHandle(scorer, separators, nextSeparators());
 }
 
 int MinimalTriangulationsEnumerator::getNumberOfMinimalSeperatorsGenerated() {
 	return separatorGraph.getNumberOfNodesGenerated();
 }
 
+/*
+ * COMBINED alternates between heuristics by the number of triangulations made
+ * so far, which depends on the extensions computed ahead of time, so with it
+ * the sets are still extended one at a time.
+ */
+void MinimalTriangulationsEnumerator::setNumberOfThreads(int threads) {
+	triExtender.setNumberOfThreads(threads);
+	setsEnumerator.setExtensionWindow(heuristic == COMBINED ? 1 : threads);
+}
+
+void MinimalTriangulationsEnumerator::setCancellationToken(CancellationTokenPtr token) {
+	setsEnumerator.setCancellationToken(token);
+}
+
+void MinimalTriangulationsEnumerator::setExcludedSeparators(
+		const vector<MinimalSeparator>& excluded) {
+	excludedSeparators.clear();
+	for (unsigned int i=0; i<excluded.size(); i++) {
+		excludedSeparators.insert(separators.intern(excluded[i]));
+	}
+}
+
+long long MinimalTriangulationsEnumerator::getNumberOfExtensionsReused() {
+	return setsEnumerator.getCacheHits();
+}
+
+long long MinimalTriangulationsEnumerator::getNumberOfExtensionsComputed() {
+	return setsEnumerator.getCacheMisses();
+}
+
 vector<ChordalGraph> MinimalTriangulationsEnumerator::getAll() {
     vector<ChordalGraph> vcg;
     while(hasNext()) {
@@ -44,5 +156,13 @@ vector<ChordalGraph> MinimalTriangulationsEnumerator::getAll() {
     return vcg;
 }
 
+vector<TriangulationHandle> MinimalTriangulationsEnumerator::getAllHandles() {
+    vector<TriangulationHandle> handles;
+    while(hasNext()) {
+        handles.push_back(nextHandle());
+    }
+    return handles;
+}
+
 } /* namespace tdenum */
 
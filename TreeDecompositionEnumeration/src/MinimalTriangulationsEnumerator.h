@@ -10,30 +10,89 @@
 
 namespace tdenum {
 
+/**
+ * A minimal triangulation returned by the enumerator, given by the IDs of its
+ * minimal separators. The fill edges and width are computed when first asked
+ * for, and the ChordalGraph is only built by getTriangulation().
+ * Valid as long as the enumerator that returned it.
+ */
+class TriangulationHandle {
+	IndSetScorerByTriangulation* scorer;
+	const NodeSetPool* separators;
+	set<NodeSetId> separatorIds;
+	bool hasFillEdges;
+	vector< pair<Node,Node> > fillEdges;
+	int width;
+public:
+	TriangulationHandle(IndSetScorerByTriangulation& scorer,
+			const NodeSetPool& pool, const set<NodeSetId>& ids);
+	// Returns the minimal separators of the triangulation
+	const set<NodeSetId>& getSeparatorIds() const;
+	set<MinimalSeparator> getSeparators() const;
+	// Returns the edges of the triangulation that are not in the graph
+	const vector< pair<Node,Node> >& getFillEdges();
+	// Returns the number of fill edges
+	int getFillIn();
+	// Returns the tree-width of the triangulation
+	int getTreeWidth();
+	// Builds the triangulation
+	ChordalGraph getTriangulation();
+};
+
 /**
  * Enumerates the minimal triangulations of a graph
  */
 class MinimalTriangulationsEnumerator {
-	Graph graph;
+	GraphPtr graph; // Shared by all the engines below
+	TriangulationAlgorithm heuristic;
+	// All minimal separators seen by the engines below, which refer to them by ID
+	NodeSetPool separators;
 	SeparatorGraph separatorGraph;
 	MinimalTriangulator triangulator;
 	IndSetExtByTriangulation triExtender;
 	IndSetExtBySeparators sepExtender;
 	IndSetScorerByTriangulation scorer;
-	MaximalIndependentSetsEnumerator<MinimalSeparator> setsEnumerator;
+	MaximalIndependentSetsEnumerator<NodeSetId> setsEnumerator;
+	// Triangulations containing these minimal separators are skipped
+	set<NodeSetId> excludedSeparators;
+	bool hasNextSet;
+	set<NodeSetId> nextSet;
+	// Returns the minimal separators of the next triangulation not skipped
+	set<NodeSetId> nextSeparators();
+	// The engines refer to graph and separators, so copying is not allowed
+	MinimalTriangulationsEnumerator(const MinimalTriangulationsEnumerator&);
+	MinimalTriangulationsEnumerator& operator=(const MinimalTriangulationsEnumerator&);
 public:
 	// initialization
-	MinimalTriangulationsEnumerator(const Graph& g, TriangulationScoringCriterion triC,
+	MinimalTriangulationsEnumerator(Graph g, TriangulationScoringCriterion triC,
+			SeparatorsScoringCriterion sepC, TriangulationAlgorithm heuristic);
+	MinimalTriangulationsEnumerator(GraphPtr g, TriangulationScoringCriterion triC,
 			SeparatorsScoringCriterion sepC, TriangulationAlgorithm heuristic);
 	// Checks whether there is another minimal triangulation
 	bool hasNext();
 	// Returns another minimal triangulation
 	ChordalGraph next();
+	// Returns another minimal triangulation, without building it
+	TriangulationHandle nextHandle();
 	// Returns the number of minimal separators generated
 	int getNumberOfMinimalSeperatorsGenerated();
+	// Lets up to the given number of triangulations be computed in parallel.
+	// The triangulations are returned in the same order as with one thread.
+	void setNumberOfThreads(int threads);
+	// Stops the enumeration once the token is cancelled
+	void setCancellationToken(CancellationTokenPtr token);
+	// Skips the triangulations containing any of the given node sets as a
+	// minimal separator. They are checked by their IDs, before the
+	// triangulations are built.
+	void setExcludedSeparators(const vector<MinimalSeparator>& excluded);
+	// Returns how many set extensions were reused, and how many were computed
+	long long getNumberOfExtensionsReused();
+	long long getNumberOfExtensionsComputed();
 	// Get all triangulations, return them in an ordered vector.
 	// After calling getAll(), hasNext() should return false.
 	vector<ChordalGraph> getAll();
+	// Same as getAll(), without building the triangulations
+	vector<TriangulationHandle> getAllHandles();
 };
 
 } /* namespace tdenum */
@@ -1,5 +1,6 @@
 #include "MinimalTriangulator.h"
 #include "DataStructures.h"
+#include "Converter.h"
 #include <map>
 #include <algorithm>
 #include <iterator>
@@ -8,74 +9,110 @@ namespace tdenum {
 
 MinimalTriangulator::MinimalTriangulator(TriangulationAlgorithm h) : heuristic(h), time(0) {}
 
-// implementing MSC-M algorithm
-ChordalGraph getMinimalTriangulationUsingMSCM(const Graph& g) {
+// implementing MSC-M algorithm.
+// Fills fillEdges with the edges added to g, using only the workspace members.
+// The weight of a node when it is popped is the number of earlier nodes it is
+// adjacent to in the triangulation. If it is not larger than the previous
+// weight, these nodes form a minimal separator of the triangulation.
+template<class G>
+void MinimalTriangulator::runMCSM(const G& g, set<MinimalSeparator>* separators) {
 	// initialize structures
-	ChordalGraph triangulation(g); // holds the result
-	IncreasingWeightNodeQueue queue(g.getNumberOfNodes());
-	vector<bool> handled (g.getNumberOfNodes(), false);
+	int n = g.getNumberOfNodes();
+	mcsQueue.reset(n);
+	handled.assign(n, false);
+	reachedIn.assign(n, -1);
+	if ((int)reachedByMaxWeight.size() < n) {
+		reachedByMaxWeight.resize(n);
+	}
+	fillEdges.clear();
+	if (separators != NULL) {
+		numberedNeighbors.resize(max((int)numberedNeighbors.size(), n));
+		for (int v=0; v<n; v++) {
+			numberedNeighbors[v].clear();
+		}
+	}
+	int previousWeight = -1;
 	// start search
-	while (!queue.isEmpty()) {
+	for (int search = 0; !mcsQueue.isEmpty(); search++) {
 		// Pop node from queue
-		Node v = queue.pop();
+		Node v = mcsQueue.pop();
 		handled[v] = true;
-		// Find nodes to update
-		NodeSet nodesToUpdate;
-		vector<bool> reached(g.getNumberOfNodes(), false);
-		vector<NodeSet> reachedByMaxWeight(g.getNumberOfNodes(), vector<Node>());
-		for (set<Node>::iterator i=g.getNeighbors(v).begin(); i!=g.getNeighbors(v).end(); ++i) {
-			Node u = *i;
+		if (separators != NULL) {
+			int weight = mcsQueue.getWeight(v);
+			if (weight <= previousWeight && !numberedNeighbors[v].empty()) {
+				sort(numberedNeighbors[v].begin(), numberedNeighbors[v].end());
+				separators->insert(numberedNeighbors[v]);
+			}
+			previousWeight = weight;
+		}
+		// Find nodes to update. The unhandled neighbors come first, the rest
+		// are reached through paths and are the fill edges.
+		nodesToUpdate.clear();
+		int pending = 0; // Number of nodes in reachedByMaxWeight
+		forEachNeighbor(g, v, [&](Node u) {
 			if (!handled[u]) {
 				nodesToUpdate.push_back(u);
-				reached[u] = true;
-				reachedByMaxWeight[queue.getWeight(u)].push_back(u);
+				reachedIn[u] = search;
+				reachedByMaxWeight[mcsQueue.getWeight(u)].push_back(u);
+				pending++;
 			}
-		}
-		for (int maxWeight=0; maxWeight<g.getNumberOfNodes(); maxWeight++) {
+		});
+		unsigned int numberOfNeighbors = nodesToUpdate.size();
+		for (int maxWeight=0; pending > 0; maxWeight++) {
 			while (!reachedByMaxWeight[maxWeight].empty()) {
 				Node w = reachedByMaxWeight[maxWeight].back();
 				reachedByMaxWeight[maxWeight].pop_back();
-				for (set<Node>::iterator i=g.getNeighbors(w).begin(); i!=g.getNeighbors(w).end(); ++i) {
-					Node u = *i;
-					if (!handled[u] && !reached[u]) {
-						if (queue.getWeight(u) > maxWeight) {
+				pending--;
+				forEachNeighbor(g, w, [&](Node u) {
+					if (!handled[u] && reachedIn[u] != search) {
+						if (mcsQueue.getWeight(u) > maxWeight) {
 							nodesToUpdate.push_back(u);
 						}
-						reached[u] = true;
-						reachedByMaxWeight[max(queue.getWeight(u), maxWeight)].push_back(u);
+						reachedIn[u] = search;
+						reachedByMaxWeight[max(mcsQueue.getWeight(u), maxWeight)].push_back(u);
+						pending++;
 					}
-				}
+				});
 			}
 		}
 		// Update nodes
-		for (NodeSet::iterator j=nodesToUpdate.begin(); j!=nodesToUpdate.end(); ++j) {
-			Node u = *j;
-			queue.increaseWeight(u);
-			triangulation.addEdge(u, v);
+		for (unsigned int j=0; j<nodesToUpdate.size(); j++) {
+			Node u = nodesToUpdate[j];
+			mcsQueue.increaseWeight(u);
+			if (j >= numberOfNeighbors) {
+				fillEdges.push_back(make_pair(u, v));
+			}
+			if (separators != NULL) {
+				numberedNeighbors[u].push_back(v);
+			}
 		}
 	}
-	return triangulation;
 }
 
+const vector< pair<Node,Node> >& MinimalTriangulator::getMCSMFillEdges(const Graph& g) {
+	runMCSM(g);
+	return fillEdges;
+}
+
+const vector< pair<Node,Node> >& MinimalTriangulator::getMCSMFillEdges(const OverlayGraph& g) {
+	runMCSM(g);
+	return fillEdges;
+}
 
+
+// Returns the number of non adjacent pairs in the neighborhood of v
 int getFill(const Graph& g, Node v) {
 	const set<Node>& neighborsSet = g.getNeighbors(v);
-	int twiceFillEdges = 0;
-	// for every node in the neighborhood, add the number of non-neighbors
+	int fillEdges = 0;
 	for (set<Node>::iterator it=neighborsSet.begin(); it!=neighborsSet.end(); ++it) {
-		vector<bool> notNeighborsOfCurrentNode = g.getNeighborsMap(v);
-		notNeighborsOfCurrentNode[*it] = false;
-		const set<Node>& neighborsOfCurrentNode = g.getNeighbors(*it);
-		for (set<Node>::iterator jt=neighborsOfCurrentNode.begin(); jt!=neighborsOfCurrentNode.end(); ++jt) {
-			notNeighborsOfCurrentNode[*jt] = false;
-		}
-		for (int i=0; i<g.getNumberOfNodes(); i++) {
-			if (notNeighborsOfCurrentNode[i]) {
-				twiceFillEdges++;
+		set<Node>::iterator jt = it;
+		for (++jt; jt!=neighborsSet.end(); ++jt) {
+			if (!g.areNeighbors(*it, *jt)) {
+				fillEdges++;
 			}
 		}
 	}
-	return twiceFillEdges/2;
+	return fillEdges;
 }
 
 // Returns the minimal separators included in the neighborhood of v
@@ -99,10 +136,33 @@ void makeNodeLBSimplicial(const Graph& g, Graph& gi, Node v) {
 	gi.saturateNodeSets(substars);
 }
 
+// Same, and appends the edges added to gi to addedEdges
+void makeNodeLBSimplicial(const Graph& g, Graph& gi, Node v,
+		vector< pair<Node,Node> >& addedEdges) {
+	set<NodeSet> substars =  getSubstars(g, gi, v);
+	for (set<NodeSet>::iterator s=substars.begin(); s!=substars.end(); ++s) {
+		for (unsigned int i=0; i<s->size(); i++) {
+			for (unsigned int j=i+1; j<s->size(); j++) {
+				if (!gi.areNeighbors((*s)[i], (*s)[j])) {
+					gi.addEdge((*s)[i], (*s)[j]);
+					addedEdges.push_back(make_pair((*s)[i], (*s)[j]));
+				}
+			}
+		}
+	}
+}
+
+/*
+ * The order in which LB-Triang handles the nodes, by min-degree or min-fill.
+ * For the non-initial heuristics, the scores are kept up to date as edges
+ * are added to the graph by rescoring only the nodes the new edges affect.
+ */
 class NodeQueue {
-	set< pair<int,Node> > queue;
 	const Graph& graph;
 	TriangulationAlgorithm heuristic;
+	UpdatableWeightNodeQueue queue;
+	vector<int> rescoredIn; // The last call to edgesAdded that rescored each node
+	int updates;
 	int score(Node v) {
 		if (heuristic == MIN_DEGREE_LB_TRIANG || heuristic == INITIAL_DEGREE_LB_TRIANG) {
 			return graph.getNeighbors(v).size();
@@ -111,31 +171,50 @@ class NodeQueue {
 		}
 		return 0;
 	}
-public:
-	NodeQueue(const Graph& g, TriangulationAlgorithm h) : graph(g), heuristic(h) {
-		for (Node v=0; v<g.getNumberOfNodes(); v++) {
-			queue.insert(make_pair(score(v), v));
+	vector<int> initialScores() {
+		vector<int> scores(graph.getNumberOfNodes());
+		for (Node v=0; v<graph.getNumberOfNodes(); v++) {
+			scores[v] = score(v);
+		}
+		return scores;
+	}
+	void rescore(Node v) {
+		if (queue.contains(v) && rescoredIn[v] != updates) {
+			rescoredIn[v] = updates;
+			queue.setWeight(v, score(v));
 		}
 	}
+public:
+	NodeQueue(const Graph& g, TriangulationAlgorithm h) : graph(g), heuristic(h),
+			queue(initialScores()), rescoredIn(g.getNumberOfNodes(), -1), updates(0) {}
 	Node pop() {
-		Node top = queue.begin()->second;
-		// check if score was updates in relevant heuristics
-		if (heuristic == MIN_DEGREE_LB_TRIANG || heuristic == MIN_FILL_LB_TRIANG || heuristic == COMBINED) {
-			int savedScore = queue.begin()->first;
-			int currentScore = score(top);
-			while (currentScore > savedScore) {
-				queue.erase(queue.begin());
-				queue.insert(make_pair(currentScore,top));
-				top = queue.begin()->second;
-				savedScore = queue.begin()->first;
-				currentScore = score(top);
+		return queue.pop();
+	}
+	// Updates the scores after the given edges were added to the graph.
+	// The degree changes only at the endpoints of a new edge; the fill also
+	// changes at their common neighbors.
+	void edgesAdded(const vector< pair<Node,Node> >& edges) {
+		if (heuristic != MIN_DEGREE_LB_TRIANG && heuristic != MIN_FILL_LB_TRIANG
+				&& heuristic != COMBINED) {
+			return;
+		}
+		updates++;
+		for (unsigned int i=0; i<edges.size(); i++) {
+			Node a = edges[i].first, b = edges[i].second;
+			rescore(a);
+			rescore(b);
+			if (heuristic != MIN_DEGREE_LB_TRIANG) {
+				const set<Node>& aNeighbors = graph.getNeighbors(a);
+				for (set<Node>::const_iterator it=aNeighbors.begin(); it!=aNeighbors.end(); ++it) {
+					if (graph.areNeighbors(*it, b)) {
+						rescore(*it);
+					}
+				}
 			}
 		}
-		queue.erase(queue.begin());
-		return top;
 	}
 	bool isEmpty() {
-		return queue.empty();
+		return queue.isEmpty();
 	}
 };
 
@@ -148,8 +227,11 @@ ChordalGraph getMinimalTriangulationUsingLBTriang(const Graph& g, TriangulationA
 		}
 	} else {
 		NodeQueue queue(result, heuristic);
+		vector< pair<Node,Node> > addedEdges;
 		while (!queue.isEmpty()) {
-			makeNodeLBSimplicial(g, result, queue.pop());
+			addedEdges.clear();
+			makeNodeLBSimplicial(g, result, queue.pop(), addedEdges);
+			queue.edgesAdded(addedEdges);
 		}
 	}
 	return result;
@@ -157,11 +239,58 @@ ChordalGraph getMinimalTriangulationUsingLBTriang(const Graph& g, TriangulationA
 
 
 ChordalGraph MinimalTriangulator::triangulate(const Graph& g) {
+	ChordalGraph triangulation(g);
+	triangulateInPlace(triangulation);
+	return triangulation;
+}
+
+void MinimalTriangulator::triangulateInPlace(Graph& g) {
 	time++;
 	if (heuristic == MCS_M || (heuristic == COMBINED && time % 2 == 0)) {
-		return getMinimalTriangulationUsingMSCM(g);
+		runMCSM(g);
+		for (unsigned int i=0; i<fillEdges.size(); i++) {
+			g.addEdge(fillEdges[i].first, fillEdges[i].second);
+		}
+		return;
+	}
+	g = getMinimalTriangulationUsingLBTriang(g, heuristic);
+}
+
+void MinimalTriangulator::triangulateInPlace(OverlayGraph& g) {
+	time++;
+	if (heuristic == MCS_M || (heuristic == COMBINED && time % 2 == 0)) {
+		runMCSM(g);
+		for (unsigned int i=0; i<fillEdges.size(); i++) {
+			g.addEdge(fillEdges[i].first, fillEdges[i].second);
+		}
+		return;
+	}
+	triangulateUsingLBTriang(g);
+}
+
+set<MinimalSeparator> MinimalTriangulator::triangulateToMinimalSeparators(OverlayGraph& g) {
+	time++;
+	set<MinimalSeparator> separators;
+	if (heuristic == MCS_M || (heuristic == COMBINED && time % 2 == 0)) {
+		runMCSM(g, &separators);
+		return separators;
+	}
+	triangulateUsingLBTriang(g);
+	return Converter::triangulationToMinimalSeparators(g);
+}
+
+void MinimalTriangulator::triangulateUsingLBTriang(OverlayGraph& g) {
+	// LB-Triang changes the graph as it goes, so it works on a copy
+	Graph saturated = g.getBase();
+	vector< pair<Node,Node> > addedEdges = g.getAddedEdges();
+	for (unsigned int i=0; i<addedEdges.size(); i++) {
+		saturated.addEdge(addedEdges[i].first, addedEdges[i].second);
+	}
+	ChordalGraph triangulation = getMinimalTriangulationUsingLBTriang(saturated, heuristic);
+	vector< set<Node> > fill = triangulation.getFillEdges(saturated);
+	for (unsigned int i=0; i<fill.size(); i++) {
+		g.addEdge(*fill[i].begin(), *fill[i].rbegin());
 	}
-	return getMinimalTriangulationUsingLBTriang(g, heuristic);
 }
 
 
@@ -2,6 +2,8 @@
 #define MINIMALTRIANGULATOR_H_
 
 #include "ChordalGraph.h"
+#include "DataStructures.h"
+#include "OverlayGraph.h"
 
 namespace tdenum {
 
@@ -11,13 +13,46 @@ enum TriangulationAlgorithm { MCS_M, MIN_FILL_LB_TRIANG, INITIAL_FILL_LB_TRIANG,
 /**
  * Calculates a minimal triangulation of the graph
  * Implements MSC-M or LB-Triang with min-fill or min-dgree heuristics
+ *
+ * The MCS-M workspace is kept between calls and only grows when a larger
+ * graph is given, so repeated MCS-M triangulations don't allocate.
+ * Graphs can also be given as an OverlayGraph, in which case MCS-M adds the
+ * fill edges to the view; the LB-Triang variants work on a copy of the graph.
+ *
+ * triangulateToMinimalSeparators() returns the minimal separators of the
+ * triangulation instead of the triangulation. MCS-M finds them in the same
+ * pass, as in the MCS-M+ algorithm of:
+ * A. Berry and R. Pogorelcnik. A simple algorithm to generate the minimal
+ * separators and the maximal cliques of a chordal graph.
  */
 class MinimalTriangulator {
 	TriangulationAlgorithm heuristic;
 	int time;
+	// MCS-M workspace
+	IncreasingWeightNodeQueue mcsQueue;
+	vector<bool> handled;
+	vector<int> reachedIn; // The search (by handled node count) that reached each node
+	vector<NodeSet> reachedByMaxWeight;
+	NodeSet nodesToUpdate;
+	vector< pair<Node,Node> > fillEdges;
+	vector<NodeSet> numberedNeighbors; // The earlier nodes adjacent in the triangulation
+	// If separators is not NULL, the minimal separators of the triangulation
+	// are added to it
+	template<class G> void runMCSM(const G& g, set<MinimalSeparator>* separators = NULL);
+	void triangulateUsingLBTriang(OverlayGraph& g);
 public:
 	MinimalTriangulator(TriangulationAlgorithm h);
 	ChordalGraph triangulate(const Graph& g);
+	// Triangulates g itself, saving the copy made by triangulate()
+	void triangulateInPlace(Graph& g);
+	void triangulateInPlace(OverlayGraph& g);
+	// Triangulates g and returns the minimal separators of the triangulation.
+	// The fill edges are only added to g if LB-Triang is used.
+	set<MinimalSeparator> triangulateToMinimalSeparators(OverlayGraph& g);
+	// Runs MCS-M on g and returns the fill edges of the resulting minimal
+	// triangulation. Valid until the next call.
+	const vector< pair<Node,Node> >& getMCSMFillEdges(const Graph& g);
+	const vector< pair<Node,Node> >& getMCSMFillEdges(const OverlayGraph& g);
 };
 
 } /* namespace tdenum */
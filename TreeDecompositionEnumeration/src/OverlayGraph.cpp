@@ -0,0 +1,54 @@
+#include "OverlayGraph.h"
+#include <algorithm>
+
+namespace tdenum {
+
+OverlayGraph::OverlayGraph(const Graph& g) :
+		base(&g), addedNeighbors(g.getNumberOfNodes()) {}
+
+void OverlayGraph::clear() {
+	for (vector<Node>::iterator it = touched.begin(); it != touched.end(); ++it) {
+		addedNeighbors[*it].clear();
+	}
+	touched.clear();
+	addedEdges.clear();
+}
+
+void OverlayGraph::addEdge(Node u, Node v) {
+	if (u == v || areNeighbors(u,v)) {
+		return;
+	}
+	addedEdges.insert(edgeKey(u,v));
+	if (addedNeighbors[u].empty()) {
+		touched.push_back(u);
+	}
+	if (addedNeighbors[v].empty()) {
+		touched.push_back(v);
+	}
+	addedNeighbors[u].insert(lower_bound(addedNeighbors[u].begin(), addedNeighbors[u].end(), v), v);
+	addedNeighbors[v].insert(lower_bound(addedNeighbors[v].begin(), addedNeighbors[v].end(), u), u);
+}
+
+void OverlayGraph::addClique(const NodeSet& s) {
+	for (unsigned int i=0; i<s.size(); i++) {
+		for (unsigned int j=i+1; j<s.size(); j++) {
+			addEdge(s[i], s[j]);
+		}
+	}
+}
+
+vector< pair<Node,Node> > OverlayGraph::getAddedEdges() const {
+	vector< pair<Node,Node> > edges;
+	for (vector<Node>::const_iterator jt = touched.begin(); jt != touched.end(); ++jt) {
+		Node v = *jt;
+		for (vector<Node>::const_iterator it = addedNeighbors[v].begin();
+				it != addedNeighbors[v].end(); ++it) {
+			if (v < *it) {
+				edges.push_back(make_pair(v, *it));
+			}
+		}
+	}
+	return edges;
+}
+
+} /* namespace tdenum */
@@ -0,0 +1,80 @@
+#ifndef OVERLAYGRAPH_H_
+#define OVERLAYGRAPH_H_
+
+#include "Graph.h"
+#include <unordered_set>
+
+namespace tdenum {
+
+/**
+ * A view of a graph with added edges. The base graph is not copied or changed;
+ * the added edges are kept on the side, so saturating a few node sets and
+ * triangulating costs memory in the number of added edges only.
+ *
+ * The base graph must outlive the view. clear() removes the added edges in
+ * time proportional to their number, so a view can be reused for many
+ * extensions of the same graph.
+ */
+class OverlayGraph {
+	const Graph* base;
+	vector< vector<Node> > addedNeighbors; // Sorted
+	unordered_set<unsigned long long> addedEdges; // Keys of (smaller, larger)
+	vector<Node> touched; // Nodes with added neighbors
+	static unsigned long long edgeKey(Node u, Node v) {
+		return u < v ? ((unsigned long long)u << 32) | (unsigned int)v
+				: ((unsigned long long)v << 32) | (unsigned int)u;
+	}
+public:
+	OverlayGraph(const Graph& g);
+	// Removes the added edges
+	void clear();
+	const Graph& getBase() const { return *base; }
+	int getNumberOfNodes() const { return base->getNumberOfNodes(); }
+	// Returns the number of edges of the base graph and added edges together
+	int getNumberOfEdges() const { return base->getNumberOfEdges() + addedEdges.size(); }
+	bool areNeighbors(Node u, Node v) const {
+		return base->areNeighbors(u,v) || addedEdges.find(edgeKey(u,v)) != addedEdges.end();
+	}
+	// Connects the given two nodes by an edge, if they aren't already
+	void addEdge(Node u, Node v);
+	// Adds edges that will make that given node set a clique
+	void addClique(const NodeSet& s);
+	// Returns the added edges
+	vector< pair<Node,Node> > getAddedEdges() const;
+	// Calls f on each neighbor of v, in ascending order
+	template<class F> void forEachNeighbor(Node v, F f) const {
+		const set<Node>& baseNeighbors = base->getNeighbors(v);
+		const vector<Node>& added = addedNeighbors[v];
+		set<Node>::const_iterator i = baseNeighbors.begin();
+		vector<Node>::const_iterator j = added.begin();
+		while (i != baseNeighbors.end() && j != added.end()) {
+			if (*i < *j) {
+				f(*i++);
+			} else {
+				f(*j++);
+			}
+		}
+		for (; i != baseNeighbors.end(); ++i) {
+			f(*i);
+		}
+		for (; j != added.end(); ++j) {
+			f(*j);
+		}
+	}
+};
+
+// Calls f on each neighbor of v, in ascending order, so that algorithms can be
+// written once for graphs and views
+template<class F> void forEachNeighbor(const Graph& g, Node v, F f) {
+	for (set<Node>::const_iterator i = g.getNeighbors(v).begin();
+			i != g.getNeighbors(v).end(); ++i) {
+		f(*i);
+	}
+}
+template<class F> void forEachNeighbor(const OverlayGraph& g, Node v, F f) {
+	g.forEachNeighbor(v, f);
+}
+
+} /* namespace tdenum */
+
+#endif /* OVERLAYGRAPH_H_ */
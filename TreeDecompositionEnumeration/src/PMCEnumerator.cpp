@@ -3,6 +3,7 @@
 #include "Utils.h"
 #include <set>
 #include <algorithm>
+#include <atomic>
 
 namespace tdenum {
 
@@ -10,18 +11,29 @@ int PMCE_RUNMODE = PMCE_RUNMODE_FAST;
 
 /**
  * A macro used to stop everything and return if the time
- * limit is reached.
+ * limit is reached (or the token was cancelled otherwise).
  *
  * Parallelized code can't do that, so use workarounds..
  */
 #define CHECK_TIME_OR_OP(_op) do { \
-        if (limit != 0 && difftime(time(NULL),start_time) >= limit) { \
+        if (token->isCancelled()) { \
             out_of_time = true; \
             TRACE(TRACE_LVL__DEBUG, "Out of time!"); \
             _op; \
         } \
     } while(0)
 
+/**
+ * Same, for the inner loops, which may run in parallel: only reads the clock
+ * once in a while, and leaves setting out_of_time to the CHECK_TIME_OR_OP that
+ * follows the loop (a cancelled token stays cancelled).
+ */
+#define POLL_TIME_OR_OP(_op) do { \
+        if (token->poll()) { \
+            _op; \
+        } \
+    } while(0)
+
 /**
  * Verify the given container is sorted (check the runmode first).
  * Should be used in the parallel context of one_more_vertex or
@@ -32,8 +44,7 @@ int PMCE_RUNMODE = PMCE_RUNMODE_FAST;
             if (!std::is_sorted((_cont).begin(), (_cont).end())) { \
                 TRACE(TRACE_LVL__ERROR, "Unsorted NodeSet " #_cont ": " << (_cont) << ". Returning an empty set"); \
                 keep_running = false; \
-                P1 = NodeSetSet(); \
-                continue; \
+                unsorted = true; \
             } \
         } \
     } while(0)
@@ -50,34 +61,72 @@ int PMCE_RUNMODE = PMCE_RUNMODE_FAST;
 
 const PMCAlg PMCEnumerator::default_alg = PMCAlg();
 
-PMCEnumerator::PMCEnumerator(const Graph& g, time_t time_limit) :
-        graph(g),
+/**
+ * The current node names are used as the original names.
+ */
+static GraphPtr withCurrentNames(Graph g) {
+    g.forgetOriginalNames();
+    return make_shared<const Graph>(move(g));
+}
+static GraphPtr withCurrentNames(GraphPtr g) {
+    return g->isRenamed() ? withCurrentNames(*g) : g;
+}
+
+PMCEnumerator::PMCEnumerator(Graph g, double time_limit) :
+        PMCEnumerator(withCurrentNames(move(g)), time_limit) {}
+
+PMCEnumerator::PMCEnumerator(GraphPtr g, double time_limit) :
+        graph(withCurrentNames(g)),
         alg(default_alg),
         has_ms(false),
-        ms_subgraph_count(g.getNumberOfNodes()),
+        ms_subgraph_count(graph->getNumberOfNodes()),
         allow_parallel(false),
+        workspaces(1),
+        pmc_workspaces(1),
         done(false),
         limit(time_limit),
-        start_time(time(NULL)),
         out_of_time(false)
 {
+    restart_token();
     omp_init_lock(&lock);
     ms.clear();
     pmcs.clear();
-    // Use current names as originals
-    graph.forgetOriginalNames();
 }
 PMCEnumerator::~PMCEnumerator() {
     omp_destroy_lock(&lock);
 }
 
-PMCEnumerator& PMCEnumerator::reset(const Graph& g, time_t time_limit) { return (*this = PMCEnumerator(g, time_limit)); }
+PMCEnumerator& PMCEnumerator::reset(const Graph& g, double time_limit) { return (*this = PMCEnumerator(g, time_limit)); }
 
 PMCEnumerator& PMCEnumerator::set_algorithm(PMCAlg a) { alg = a; return *this; }
 PMCAlg PMCEnumerator::get_alg() const { return alg; }
 
-PMCEnumerator& PMCEnumerator::set_time_limit(time_t t) { limit = t; return *this; }
-PMCEnumerator& PMCEnumerator::unset_time_limit() { limit = 0; return *this; }
+/**
+ * The limit counts from the start of the current run, as before.
+ */
+PMCEnumerator& PMCEnumerator::set_time_limit(double t) {
+    limit = t;
+    if (limit > 0) {
+        token->setTimeLimit(limit);
+    } else {
+        token->unsetTimeLimit();
+    }
+    return *this;
+}
+PMCEnumerator& PMCEnumerator::unset_time_limit() { return set_time_limit(0); }
+
+PMCEnumerator& PMCEnumerator::set_cancellation_token(CancellationTokenPtr t) {
+    parent_token = t;
+    restart_token();
+    return *this;
+}
+
+void PMCEnumerator::restart_token() {
+    token = make_shared<CancellationToken>(parent_token);
+    if (limit > 0) {
+        token->setTimeLimit(limit);
+    }
+}
 
 PMCEnumerator& PMCEnumerator::enable_parallel() { allow_parallel = true; return *this; }
 PMCEnumerator& PMCEnumerator::suppress_parallel() { allow_parallel = false; return *this; }
@@ -87,13 +136,13 @@ PMCEnumerator& PMCEnumerator::suppress_parallel() { allow_parallel = false; retu
  * Remember to map the sets to the new node names!
  */
 PMCEnumerator& PMCEnumerator::set_minimal_separators(const NodeSetSet& min_seps) {
-    ms = graph.getNewNames(min_seps);
+    ms = graph->getNewNames(min_seps);
     has_ms = true;
-    if (graph.getNumberOfNodes() == 0) {
+    if (graph->getNumberOfNodes() == 0) {
         TRACE(TRACE_LVL__ERROR, "No nodes (empty graph)! Can't set MS count");
         return *this;
     }
-    ms_subgraph_count[graph.getNumberOfNodes()-1] = ms.size();
+    ms_subgraph_count[graph->getNumberOfNodes()-1] = ms.size();
     return *this;
 }
 
@@ -103,16 +152,16 @@ PMCEnumerator& PMCEnumerator::set_minimal_separators(const NodeSetSet& min_seps)
 NodeSetSet PMCEnumerator::get_ms() {
     if (!has_ms) {
         ms.clear();
-        if (graph.getNumberOfNodes() == 0) {
+        if (graph->getNumberOfNodes() == 0) {
             TRACE(TRACE_LVL__NOISE, "Empty graph yields an empty set of minimal separators.");
             set_minimal_separators(NodeSetSet());
             return ms;
         }
         MinimalSeparatorsEnumerator mse(graph, UNIFORM);
-        if (!mse.getAll(ms, difftime(limit,difftime(time(NULL),start_time)))) {
+        if (!mse.getAll(ms, *token)) {
             out_of_time = true;
         }
-        ms_subgraph_count[graph.getNumberOfNodes()-1] = ms.size();
+        ms_subgraph_count[graph->getNumberOfNodes()-1] = ms.size();
         has_ms = true;
     }
     return ms;
@@ -120,17 +169,17 @@ NodeSetSet PMCEnumerator::get_ms() {
 vector<NodeSetSet> PMCEnumerator::get_ms_subgraphs() { return ms_subgraphs; }
 vector<long> PMCEnumerator::get_ms_count_subgraphs() { return ms_subgraph_count; }
 
-Graph PMCEnumerator::get_graph() const {
-    return graph;
+const Graph& PMCEnumerator::get_graph() const {
+    return *graph;
 }
 
 void PMCEnumerator::update_ms_subgraph_count() {
     read_ms_subgraph_count_from_vector(ms_subgraphs);
 }
 void PMCEnumerator::read_ms_subgraph_count_from_vector(const vector<NodeSetSet>& v) {
-    if (v.size() != (size_t)graph.getNumberOfNodes()) {
+    if (v.size() != (size_t)graph->getNumberOfNodes()) {
         TRACE(TRACE_LVL__ERROR, "Size mismatch: got " << v.size() << " separators " <<
-              "for a graph of size " << graph.getNumberOfNodes());
+              "for a graph of size " << graph->getNumberOfNodes());
         return;
     }
     for (unsigned i=0; i<v.size(); ++i) {
@@ -153,7 +202,7 @@ NodeSetSet PMCEnumerator::get(/*const StatisticRequest& sr*/) {
     if (!done) {
 
         // Cleanup
-        start_time = time(NULL);
+        restart_token();
         pmcs.clear();
 
         /**
@@ -162,7 +211,7 @@ NodeSetSet PMCEnumerator::get(/*const StatisticRequest& sr*/) {
          * then convert the resulting ms and pmc values to the original
          * node names.
          */
-        Graph tmp_graph = graph;
+        Graph tmp_graph = *graph;
         int n = tmp_graph.getNumberOfNodes();
 
         // If the graph is empty..
@@ -180,19 +229,17 @@ NodeSetSet PMCEnumerator::get(/*const StatisticRequest& sr*/) {
         }
         vector<Node> nodes = tmp_graph.getNodesVector();
 
-        TRACE(TRACE_LVL__NOISE, "Done renaming. Calculating subgraphs...");
-
-        // Start by creating all subgraphs.
-        // This should not constitute a memory bottleneck... if so,
-        // the graphs are WAY too large for these algorithms :)
-        vector<SubGraph> subg;
-        for (int i=1; i<=n; ++i) {
-            vector<Node> subnodes = nodes;
-            subnodes.resize(i);
-            subg.push_back(SubGraph(tmp_graph, subnodes));
+        // The prefix subgraphs are views of tmp_graph, so they share its
+        // adjacency backend.
+        if (n <= PMCE_BITSET_MAX_NODES) {
+            tmp_graph.setAdjacency(ADJACENCY_BITSET);
         }
 
-        TRACE(TRACE_LVL__NOISE, "Done calculating subgraphs. Is the algorithm a reverse-MS type?");
+        // Node i is nodes[i]=i after renaming, so the subgraph of the first
+        // i+1 nodes is the prefix view of size i+1. Nothing is copied.
+        auto subg = [&tmp_graph](int i) { return PrefixGraph(tmp_graph, i+1); };
+
+        TRACE(TRACE_LVL__NOISE, "Done renaming. Is the algorithm a reverse-MS type?");
 
         // Optionally use the (memory-inefficient) algorithm, which
         // calculates the minimal separators in advance:
@@ -234,12 +281,13 @@ NodeSetSet PMCEnumerator::get(/*const StatisticRequest& sr*/) {
                     if (checked_seps.isMember(S)) {
                         continue;
                     }
-                    // Get connected components of subg[i](S)
-                    auto components = subg[i].getComponents(S);
+                    // Get the blocks of S in subg(i). A component is full
+                    // <==> its neighbors in S are all of S.
                     // Count how many are full components. Stop at 2.
+                    const FlatBlockVec& B = subg(i).getBlocks(S, workspaces[0]);
                     int full_components = 0;
-                    for (auto C: components) {
-                        if (subg[i].isFullComponent(C,S)) {
+                    for (unsigned j=0; j<B.size(); ++j) {
+                        if (B.S(j) == S) {
                             ++full_components;
                             if (full_components >= 2) {
                                 break;
@@ -288,26 +336,26 @@ NodeSetSet PMCEnumerator::get(/*const StatisticRequest& sr*/) {
             // The NORMAL algorithm requires calculation of separators
             if (!alg.is_reverse()) {
                 if (i == n-1) {
-                    TRACE(TRACE_LVL__OFF, "Last iteration, moving from:" << endl << subg[i-1] <<
-                                           "To (by adding node " << a << "):" << endl << subg[i] <<
+                    TRACE(TRACE_LVL__OFF, "Last iteration, moving from:" << endl << subg(i-1) <<
+                                           "To (by adding node " << a << "):" << endl << subg(i) <<
                                            "With minimal separators " << MSi << " and " <<
                                            tmp_graph.getNewNames(get_ms()) << ", respectively.");
-                    pmcs = one_more_vertex(subg[n-1], subg[n-2], a, sub_ms[n-1], MSi, prev_pmcs);
+                    pmcs = one_more_vertex(subg(n-1), subg(n-2), a, sub_ms[n-1], MSi, prev_pmcs);
                 }
                 else {
-                    MinimalSeparatorsEnumerator DiEnumerator(subg[i], UNIFORM);
-                    DiEnumerator.getAll(MSip1, difftime(limit,difftime(time(NULL),start_time)));
+                    MinimalSeparatorsEnumerator DiEnumerator(subg(i).toGraph(), UNIFORM);
+                    DiEnumerator.getAll(MSip1, *token);
                     CHECK_TIME_OR_OP(return NodeSetSet());
                     sub_ms[i] = MSip1;
                     ms_subgraph_count[i] = MSip1.size();
-                    pmcs = one_more_vertex(subg[i], subg[i-1], a, MSip1, MSi, prev_pmcs);
+                    pmcs = one_more_vertex(subg(i), subg(i-1), a, MSip1, MSi, prev_pmcs);
                 }
                 TRACE(TRACE_LVL__OFF, "Current pmcs: " << tmp_graph.getOriginalNames(pmcs));
             }
             else {
-                pmcs = one_more_vertex(subg[i], subg[i-1], a, sub_ms[i], sub_ms[i-1], prev_pmcs);
+                pmcs = one_more_vertex(subg(i), subg(i-1), a, sub_ms[i], sub_ms[i-1], prev_pmcs);
                 TRACE(TRACE_LVL__OFF, "With i=" << i << ", where the parent graph is:" << endl
-                      << subg[i] << "and the subgraph is:" << endl << subg[i-1]
+                      << subg(i) << "and the subgraph is:" << endl << subg(i-1)
                       << "We have minimal separators " << sub_ms[i] << " and " << sub_ms[i-1]
                       << ", main graph / subgraph respectively. As a result, we got PMCs " << pmcs);
             }
@@ -339,20 +387,32 @@ NodeSetSet PMCEnumerator::get(/*const StatisticRequest& sr*/) {
     return pmcs;
 }
 
+/**
+ * Adds the PMCs found by every thread to P, which drops the duplicates.
+ */
+static void merge_found(vector< vector<NodeSet> >& found, NodeSetSet& P) {
+    for (unsigned t=0; t<found.size(); ++t) {
+        for (unsigned i=0; i<found[t].size(); ++i) {
+            P.insert(found[t][i]);
+        }
+        found[t].clear();
+    }
+}
+
 /**
  * May use asynchronous code.
- * Note that in such code, the only shared variables used by
- * threads are P1 and G1. P1 is always wrapped by a locking method
- * insert_critical, and G1 is always sent as a const argument to
- * is_pmc, so it should be fine.
- * 'a' is only read.
+ * The candidates are materialized into arrays, so the loops over them are
+ * scheduled dynamically, and every thread collects the PMCs it finds in its
+ * own vector. They are merged into P1 after each loop, so no locks are taken.
+ * G1 is always sent as a const argument to is_pmc, and 'a' is only read.
  */
 NodeSetSet PMCEnumerator::one_more_vertex(
-                  const SubGraph& G1, const SubGraph& G2, Node a,
+                  const PrefixGraph& G1, const PrefixGraph& G2, Node a,
                   const NodeSetSet& D1, const NodeSetSet& D2,
                   const NodeSetSet& P2) {
     NodeSetSet P1;
-    bool keep_running = true;   // For async code
+    atomic<bool> keep_running(true);    // For async code
+    atomic<bool> unsorted(false);       // Set by VERIFY_SORT_OMV
 
     // If a supports d(a)=0, then the regular algorithm won't add
     // {a} as a PMC, even though it should.
@@ -364,91 +424,109 @@ NodeSetSet PMCEnumerator::one_more_vertex(
         return P1;
     }
 
+    // Make sure every thread in the team has its own workspace and results
+    bool parallel = allow_parallel || alg.is_parallel();
+    int threads = parallel ? omp_get_max_threads() : 1;
+    if (workspaces.size() < (unsigned int)threads) {
+        workspaces.resize(threads);
+        pmc_workspaces.resize(threads);
+    }
+    vector< vector<NodeSet> > found(threads);
+
     TRACE(TRACE_LVL__NOISE, "Starting first parallel loop...");
 
-    #pragma omp parallel if(allow_parallel)
-    {
-        for (auto pmc2it=P2.begin(); keep_running && pmc2it != P2.end(); ++pmc2it) {
-            #pragma omp single nowait
-            {
-                auto potential = *pmc2it;
-                if (is_pmc(potential, G1)) {
-                    utils__insert_critical(potential, P1);
-                }
-                else {
-                    NodeSet pmc2a = potential;
-                    pmc2a.insert(pmc2a.end(), a); // should already be sorted as a is bigger than previous nodes
-                    if (is_pmc(pmc2a, G1)) {
-                        utils__insert_critical(pmc2a, P1);
-                    }
-                }
-                #pragma omp critical
-                {
-                    CHECK_TIME_OR_OP(keep_running = false);
-                }
+    vector<const NodeSet*> candidates;
+    candidates.reserve(P2.size());
+    for (auto pmc2it=P2.begin(); pmc2it != P2.end(); ++pmc2it) {
+        candidates.push_back(&*pmc2it);
+    }
+
+    #pragma omp parallel for schedule(dynamic) if(parallel)
+    for (int c=0; c<(int)candidates.size(); ++c) {
+        if (!keep_running) {
+            continue;
+        }
+        vector<NodeSet>& out = found[omp_get_thread_num()];
+        const NodeSet& potential = *candidates[c];
+        if (is_pmc(potential, G1)) {
+            out.push_back(potential);
+        }
+        else {
+            NodeSet pmc2a = potential;
+            pmc2a.insert(pmc2a.end(), a); // should already be sorted as a is bigger than previous nodes
+            if (is_pmc(pmc2a, G1)) {
+                out.push_back(pmc2a);
             }
         }
+        POLL_TIME_OR_OP(keep_running = false);
     }
+    merge_found(found, P1);
     CHECK_TIME_OR_OP(return P1);
 
     TRACE(TRACE_LVL__NOISE, "Done with first parallel loop, starting second...");
 
-    #pragma omp parallel if(allow_parallel)
-    {
-        for (auto Sit = D1.begin(); keep_running && Sit != D1.end(); ++Sit) {
-            #pragma omp single nowait
-            {
-                // Sort S first so we can easily compare P=S later.
-                NodeSet S = *Sit;
-                NodeSet Sa = S;
-                VERIFY_SORT_OMV(Sa);
-
-                // Add a, if not already in:
-                if (!UTILS__IS_IN_SORTED_CONTAINER(a,Sa)) {
-                    Sa.insert(Sa.end(), a);
-                }
-                if (is_pmc(Sa, G1)) {
-                    utils__insert_critical(Sa, P1);
+    candidates.clear();
+    candidates.reserve(D1.size());
+    for (auto Sit = D1.begin(); Sit != D1.end(); ++Sit) {
+        candidates.push_back(&*Sit);
+    }
+
+    #pragma omp parallel for schedule(dynamic) if(parallel)
+    for (int c=0; c<(int)candidates.size(); ++c) {
+        if (!keep_running) {
+            continue;
+        }
+        vector<NodeSet>& out = found[omp_get_thread_num()];
+        // Sort S first so we can easily compare P=S later.
+        const NodeSet& S = *candidates[c];
+        NodeSet Sa = S;
+        VERIFY_SORT_OMV(Sa);
+
+        // Add a, if not already in:
+        if (!UTILS__IS_IN_SORTED_CONTAINER(a,Sa)) {
+            Sa.insert(Sa.end(), a);
+        }
+        if (is_pmc(Sa, G1)) {
+            out.push_back(Sa);
+        }
+        if (!UTILS__IS_IN_SORTED_CONTAINER(a,S) && !D2.isMember(S)) {
+
+            // For each separator S, iterate over all full components C of G
+            // associated with S. In other words, all connected components C
+            // of G\S so that the set P of all elements of S that are adjacent
+            // to some vertex of C supports P=S.
+
+            // Copy the blocks out of the workspace, is_pmc reuses it
+            FlatBlockVec blocks = G1.getBlocks(S, workspaces[omp_get_thread_num()]);
+            for (unsigned int i=0; keep_running && i<blocks.size(); ++i) {
+                // We only want full components
+                if (blocks.S(i) != S) {
+                    continue;
                 }
-                if (!UTILS__IS_IN_SORTED_CONTAINER(a,S) && !D2.isMember(S)) {
-
-                    // For each separator S, iterate over all full components C of G
-                    // associated with S. In other words, all connected components C
-                    // of G\S so that the set P of all elements of S that are adjacent
-                    // to some vertex of C supports P=S.
-
-                    BlockVec blocks = G1.getBlocks(S);
-                    for (unsigned int i=0; keep_running && i<blocks.size(); ++i) {
-                        // We only want full components
-                        if (S != blocks[i]->S) {
-                            continue;
-                        }
-                        for (auto sep2 = D2.begin(); keep_running && sep2 != D2.end(); ++sep2) {
-                            VERIFY_SORT_OMV(*sep2);
-                            VERIFY_SORT_OMV(blocks[i]->C);
-                            NodeSet TcapC;
-                            UTILS__VECTOR_INTERSECTION(*sep2, blocks[i]->C, TcapC);
-                            VERIFY_SORT_OMV(TcapC);
-                            NodeSet SuTcapC;
-                            UTILS__VECTOR_UNION(TcapC, S, SuTcapC);  // S is verified sorted (above)
-                            VERIFY_SORT_OMV(SuTcapC);
-                            if (is_pmc(SuTcapC, G1)) {
-                                utils__insert_critical(SuTcapC, P1);
-                            }
-                            #pragma omp critical
-                            {
-                                CHECK_TIME_OR_OP(keep_running = false);
-                            }
-                        }
+                NodeRange C = blocks.C(i);
+                for (auto sep2 = D2.begin(); keep_running && sep2 != D2.end(); ++sep2) {
+                    VERIFY_SORT_OMV(*sep2);
+                    VERIFY_SORT_OMV(C);
+                    NodeSet TcapC;
+                    UTILS__VECTOR_INTERSECTION(*sep2, C, TcapC);
+                    VERIFY_SORT_OMV(TcapC);
+                    NodeSet SuTcapC;
+                    UTILS__VECTOR_UNION(TcapC, S, SuTcapC);  // S is verified sorted (above)
+                    VERIFY_SORT_OMV(SuTcapC);
+                    if (is_pmc(SuTcapC, G1)) {
+                        out.push_back(SuTcapC);
                     }
-                }
-                #pragma omp critical
-                {
-                    CHECK_TIME_OR_OP(keep_running = false);
+                    POLL_TIME_OR_OP(keep_running = false);
                 }
             }
         }
+        POLL_TIME_OR_OP(keep_running = false);
+    }
+    merge_found(found, P1);
+    if (unsorted) {
+        return NodeSetSet();
     }
+    CHECK_TIME_OR_OP(((void)0));
 
     return P1;
 }
@@ -473,8 +551,11 @@ NodeSetSet PMCEnumerator::one_more_vertex(
  * Ci apart from the endpoints x and y.
  */
 
-bool PMCEnumerator::is_pmc(NodeSet K, const SubGraph& G) {
-	BlockVec B = G.getBlocks(K);
+bool PMCEnumerator::is_pmc(NodeSet K, const PrefixGraph& G) {
+    if (G.getAdjacency() == ADJACENCY_BITSET) {
+        return is_pmc_bitset(K, G);
+    }
+	const FlatBlockVec& B = G.getBlocks(K, workspaces[omp_get_thread_num()]);
 	unsigned int i,j,k;
 
 
@@ -484,12 +565,12 @@ bool PMCEnumerator::is_pmc(NodeSet K, const SubGraph& G) {
     // Build the sets Si.
     // While doing so make sure we don't have any full components
     for (i=0; i<B.size(); ++i) {
-        VERIFY_SORT_ISPMC(B[i]->S); // S must be sorted for the algorithm to work
-        if (B[i]->S == K) {
+        VERIFY_SORT_ISPMC(B.S(i)); // S must be sorted for the algorithm to work
+        if (B.S(i) == K) {
             // Uh oh.. C[i] is a full component
             return false;
         }
-        CHECK_TIME_OR_OP(return false);
+        POLL_TIME_OR_OP(return false);
     }
 
     // For each x,y in K (that aren't equal) we need to check if
@@ -497,18 +578,18 @@ bool PMCEnumerator::is_pmc(NodeSet K, const SubGraph& G) {
     for (i=0; i<K.size(); ++i) {
         Node x = K[i];
         // Find the S[i]s containing x
-        vector<NodeSet> Sx;
+        vector<NodeRange> Sx;
         for (j=0; j<B.size(); ++j) {
-            CHECK_TIME_OR_OP(return false);
+            POLL_TIME_OR_OP(return false);
             // They're all sorted, so use binary search
-            if (UTILS__IS_IN_SORTED_CONTAINER(x, B[j]->S)) {
-                Sx.push_back(B[j]->S);
+            if (B.S(j).contains(x)) {
+                Sx.push_back(B.S(j));
             }
         }
         // For every unchecked y in K (scanning forward) check adjacency
         // in the graph F
         for (j=i+1; j<K.size(); ++j) {
-            CHECK_TIME_OR_OP(return false);
+            POLL_TIME_OR_OP(return false);
             Node y = K[j];
             if (G.areNeighbors(x, y)) {
                 continue;
@@ -517,11 +598,11 @@ bool PMCEnumerator::is_pmc(NodeSet K, const SubGraph& G) {
             for (k=0; k<Sx.size(); ++k) {
                 // Sx is sorted by construction (otherwise, S is unsorted),
                 // so IS_IN_CONTAINER can be safely used.
-                if (UTILS__IS_IN_SORTED_CONTAINER(y, Sx[k])) {
+                if (Sx[k].contains(y)) {
                     foundSi = true;
                     break;
                 }
-                CHECK_TIME_OR_OP(return false);
+                POLL_TIME_OR_OP(return false);
             }
             if (!foundSi) {
                 // x and y aren't connected in F...
@@ -533,6 +614,92 @@ bool PMCEnumerator::is_pmc(NodeSet K, const SubGraph& G) {
     return true;
 }
 
+/**
+ * The same test a word at a time. Every component C of G\K is found by a BFS
+ * over the bit-matrix, which also collects its neighbors in K, S(C), as a
+ * mask. If S(C)=K, C is a full component. Otherwise every x in S(C) gets S(C)
+ * ORed into its row of F, which starts as its neighbors in K. K is a clique
+ * in F <==> every row is K.
+ */
+bool PMCEnumerator::is_pmc_bitset(const NodeSet& K, const PrefixGraph& G) {
+    PMCWorkspace& ws = pmc_workspaces[omp_get_thread_num()];
+    int n = G.getNumberOfNodes();
+    int words = G.getNumberOfNeighborWords();
+    int k = K.size();
+
+    ws.inK.assign(words, 0);
+    ws.unvisited.assign(words, ~0ULL);
+    if (n % BITWORD_BITS) {
+        ws.unvisited[words-1] = (1ULL << (n % BITWORD_BITS)) - 1;
+    }
+    ws.position.resize(n);
+    for (int i=0; i<k; ++i) {
+        Node x = K[i];
+        ws.inK[x/BITWORD_BITS] |= 1ULL << (x%BITWORD_BITS);
+        ws.unvisited[x/BITWORD_BITS] &= ~(1ULL << (x%BITWORD_BITS));
+        ws.position[x] = i;
+    }
+    ws.rows.resize(k*words);
+    for (int i=0; i<k; ++i) {
+        const BitWord* neighbors = G.getNeighborWords(K[i]);
+        BitWord* row = &ws.rows[i*words];
+        for (int w=0; w<words; ++w) {
+            row[w] = neighbors[w] & ws.inK[w];
+        }
+        row[K[i]/BITWORD_BITS] |= 1ULL << (K[i]%BITWORD_BITS);
+    }
+
+    ws.sep.resize(words);
+    for (int firstWord=0; firstWord<words; ) {
+        if (!ws.unvisited[firstWord]) {
+            firstWord++;
+            continue;
+        }
+        std::fill(ws.sep.begin(), ws.sep.end(), 0ULL);
+        BitWord first = ws.unvisited[firstWord];
+        Node start = firstWord*BITWORD_BITS + BitMatrix::popLowestBit(first);
+        ws.unvisited[firstWord] &= ~(1ULL << (start%BITWORD_BITS));
+        ws.queue.clear();
+        ws.queue.push_back(start);
+        for (unsigned int head=0; head<ws.queue.size(); ++head) {
+            const BitWord* row = G.getNeighborWords(ws.queue[head]);
+            for (int w=0; w<words; ++w) {
+                ws.sep[w] |= row[w] & ws.inK[w];
+                BitWord reached = row[w] & ws.unvisited[w];
+                if (!reached) {
+                    continue;
+                }
+                ws.unvisited[w] &= ~reached;
+                while (reached) {
+                    ws.queue.push_back(w*BITWORD_BITS + BitMatrix::popLowestBit(reached));
+                }
+            }
+        }
+        if (ws.sep == ws.inK) {
+            // Uh oh.. C is a full component
+            return false;
+        }
+        for (int w=0; w<words; ++w) {
+            BitWord members = ws.sep[w];
+            while (members) {
+                Node x = w*BITWORD_BITS + BitMatrix::popLowestBit(members);
+                BitWord* row = &ws.rows[ws.position[x]*words];
+                for (int v=0; v<words; ++v) {
+                    row[v] |= ws.sep[v];
+                }
+            }
+        }
+    }
+
+    for (int i=0; i<k; ++i) {
+        if (!std::equal(ws.inK.begin(), ws.inK.end(), ws.rows.begin() + i*words)) {
+            // x and some y aren't connected in F...
+            return false;
+        }
+    }
+    return true;
+}
+
 bool PMCEnumerator::is_out_of_time() const {
     return out_of_time;
 }
@@ -4,8 +4,9 @@
 #include "DataStructures.h"
 #include "Graph.h"
 #include "PMCAlg.h"
+#include "CancellationToken.h"
 #include "StatisticRequest.h"
-#include "SubGraph.h"
+#include "PrefixGraph.h"
 #include <omp.h>
 #include <vector>
 
@@ -19,6 +20,10 @@ typedef enum PMCERunMode {
 } PMCERunMode;
 extern int PMCE_RUNMODE;
 
+// Largest graph for which the prefix subgraphs use the bitset adjacency backend.
+// Beyond it, scanning whole rows costs more than walking sparse neighbor sets.
+#define PMCE_BITSET_MAX_NODES 1024
+
 /**
  * Constructs a list of potential maximal cliques, given a graph.
  *
@@ -33,8 +38,8 @@ private:
     // Test class
     friend class PMCEnumeratorTester;
 
-    // The graph in question, and a copy of the original for output.
-    Graph graph;
+    // The graph in question, shared with the minimal separators enumerator.
+    GraphPtr graph;
 
     // The algorithm to be used (defaults to default_alg)
     PMCAlg alg;
@@ -60,28 +65,53 @@ private:
     bool allow_parallel;
     omp_lock_t lock;
 
+    // getBlocks workspaces, indexed by OpenMP thread number
+    vector<BlocksWorkspace> workspaces;
+
+    // Scratch space of the bit-parallel is_pmc, indexed the same way.
+    // Node sets are bit-packed like the rows of the adjacency matrix.
+    struct PMCWorkspace {
+        vector<BitWord> inK;        // K
+        vector<BitWord> unvisited;  // Nodes out of K not reached yet
+        vector<BitWord> sep;        // Neighbors in K of the current component
+        vector<BitWord> rows;       // Neighbors in F of every node of K
+        vector<int> position;       // Index in K of the nodes of K
+        vector<Node> queue;
+    };
+    vector<PMCWorkspace> pmc_workspaces;
+
     // If the calculation is complete, set this to true.
     bool done;
 
     // If time limit exceeded, we need to know.
-    time_t limit;
-    time_t start_time;
+    // The token of the current run is derived from the parent token, if one
+    // was given, and gets the time limit (in seconds, 0 for none).
+    double limit;
+    CancellationTokenPtr parent_token;
+    CancellationTokenPtr token;
     bool out_of_time;
 
+    // Starts counting the time limit from now, with a fresh token.
+    void restart_token();
+
     // Call to reset members to default values.
     void set_default_member_vals();
 
     // Returns true <==> K is a potential maximal clique in G.
     // Assumes K is a subset of the vertices in G.
-    bool is_pmc(NodeSet K, const SubGraph& G);
+    bool is_pmc(NodeSet K, const PrefixGraph& G);
+    // Same, for G with the bitset adjacency backend.
+    bool is_pmc_bitset(const NodeSet& K, const PrefixGraph& G);
 
     // The iterative step of the algorithm.
     // Given graphs G1, G2, a vertex 'a' s.t. G2=G1\{a}, the minimal
     // seperators D1, D2 of G1 and G2 respectively and the potential
     // maximal cliques P2 of G2, calculates the set of potential maximal
     // cliques of G1 in polynomial time.
-    NodeSetSet one_more_vertex(const SubGraph& G1,
-                               const SubGraph& G2,
+    // G1 and G2 are prefixes of the renamed graph, with 'a' the last node
+    // of G1.
+    NodeSetSet one_more_vertex(const PrefixGraph& G1,
+                               const PrefixGraph& G2,
                                Node a,
                                const NodeSetSet& D1,
                                const NodeSetSet& D2,
@@ -96,18 +126,23 @@ private:
 public:
 
     // Construct the enumerator with the given graph.
-    // Optionally, enforce a time limit.
-    PMCEnumerator(const Graph& g, time_t time_limit = 0);
+    // Optionally, enforce a time limit (in seconds, may be fractional).
+    PMCEnumerator(Graph g, double time_limit = 0);
+    // Same, sharing the graph (unless its nodes were renamed, in which case
+    // a copy with the current names as originals is used).
+    PMCEnumerator(GraphPtr g, double time_limit = 0);
     ~PMCEnumerator();
 
     // Resets the instance to use a new graph (allows re-use of variable name).
-    PMCEnumerator& reset(const Graph& g, time_t time_limit = 0);
+    PMCEnumerator& reset(const Graph& g, double time_limit = 0);
 
     // Setters / getters
     PMCEnumerator& set_algorithm(PMCAlg a);
     PMCAlg get_alg() const;
-    PMCEnumerator& set_time_limit(time_t);
+    PMCEnumerator& set_time_limit(double);
     PMCEnumerator& unset_time_limit();
+    // Also stop (as if out of time) when the given token is cancelled.
+    PMCEnumerator& set_cancellation_token(CancellationTokenPtr);
     PMCEnumerator& enable_parallel();
     PMCEnumerator& suppress_parallel();
 
@@ -126,7 +161,7 @@ public:
     vector<long> get_ms_count_subgraphs();
 
     // Returns the underlying graph
-    Graph get_graph() const;
+    const Graph& get_graph() const;
 
     // If true, the calculation couldn't be completed in the allowed time.
     bool is_out_of_time() const;
@@ -1,3 +1,4 @@
+#include "AtomDecomposition.h"
 #include "ChordalGraph.h"
 #include "DataStructures.h"
 #include "GraphProducer.h"
@@ -588,6 +589,87 @@ bool PMCEnumeratorTester::crosscheck() const {
     return all_passed;
 }
 
+bool PMCEnumeratorTester::atomspmcs() const {
+    // Sparse graphs, most of which have clique minimal separators
+    auto gs = GraphProducer().add_random({8,10,12},{0.1,0.2,0.3}, true).get();
+    bool decomposed = false;
+    for (unsigned i=0; i<gs.size(); ++i) {
+        GraphPtr g = make_shared<const Graph>(gs[i].get_graph());
+        PMCEnumerator pmce(g);
+        ASSERT_EQ(getPotentialMaximalCliquesByAtoms(g, pmc_alg), pmce.get());
+        decomposed = decomposed || AtomDecomposition(g).getNumberOfAtoms() > 1;
+    }
+    ASSERT(decomposed);
+    return true;
+}
+
+bool PMCEnumeratorTester::ispmcpaths() const {
+    // Every subset of the nodes of small graphs, including the empty set and
+    // all the nodes, is checked by the block-based is_pmc on the sets backend
+    // and by is_pmc_bitset on the bitset backend, against the PMCs found
+    auto gs = GraphProducer().add_random({1,5,8},{0.3,0.5}, true).get();
+    for (unsigned i=0; i<gs.size(); ++i) {
+        Graph sets = gs[i].get_graph();
+        sets.setAdjacency(ADJACENCY_SETS);
+        Graph bits = sets;
+        bits.setAdjacency(ADJACENCY_BITSET);
+        PMCEnumerator pmce(sets);
+        NodeSetSet pmcs = pmce.get();
+        int n = sets.getNumberOfNodes();
+        for (int mask=0; mask < (1<<n); ++mask) {
+            NodeSet K;
+            for (Node v=0; v<n; ++v) {
+                if (mask & (1<<v)) {
+                    K.push_back(v);
+                }
+            }
+            bool expected = pmcs.isMember(K);
+            ASSERT_EQ(pmce.is_pmc(K, sets), expected);
+            ASSERT_EQ(pmce.is_pmc_bitset(K, bits), expected);
+            ASSERT_EQ(pmce.is_pmc(K, bits), expected);
+        }
+    }
+    // A graph spanning two words of the bit-matrix, and its prefixes, with
+    // the closed neighborhoods, random subsets, no nodes and all nodes
+    Graph sets(70, ADJACENCY_SETS);
+    sets.randomize(0.1);
+    Graph bits = sets;
+    bits.setAdjacency(ADJACENCY_BITSET);
+    PMCEnumerator pmce(sets);
+    for (int size : {1, 63, 64, 65, 70}) {
+        PrefixGraph prefixSets(sets, size), prefixBits(bits, size);
+        vector<NodeSet> candidates = {NodeSet()};
+        NodeSet all;
+        for (Node v=0; v<size; ++v) {
+            all.push_back(v);
+            NodeSet closed = {v};
+            for (Node u : sets.getNeighbors(v)) {
+                if (u < size) {
+                    closed.push_back(u);
+                }
+            }
+            sort(closed.begin(), closed.end());
+            candidates.push_back(closed);
+        }
+        candidates.push_back(all);
+        for (int j=0; j<100; ++j) {
+            NodeSet K;
+            for (Node v=0; v<size; ++v) {
+                if (rand() % 8 == 0) {
+                    K.push_back(v);
+                }
+            }
+            candidates.push_back(K);
+        }
+        for (const NodeSet& K : candidates) {
+            bool expected = pmce.is_pmc(K, prefixSets);
+            ASSERT_EQ(pmce.is_pmc_bitset(K, prefixBits), expected);
+            ASSERT_EQ(pmce.is_pmc(K, prefixBits), expected);
+        }
+    }
+    return true;
+}
+
 
 }
 
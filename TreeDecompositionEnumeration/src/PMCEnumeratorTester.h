@@ -39,7 +39,11 @@
     X(algorithmconsistencyparallel) \
     /* Uses existing datasets and Nofar's code to cross-check the PMC \
        algorithm with Nofar's version */ \
-    X(crosscheck)
+    X(crosscheck) \
+    /* The PMCs found on the atoms of a graph are its PMCs */ \
+    X(atomspmcs) \
+    /* The block-based and the bit-parallel is_pmc agree on both backends */ \
+    X(ispmcpaths)
 
 typedef enum {
 #define X(func) PMCENUM_TEST_NAME__##func,
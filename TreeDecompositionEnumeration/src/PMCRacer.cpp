@@ -2,6 +2,7 @@
 #include "PMCEnumerator.h"
 #include "PMCRacer.h"
 #include "Utils.h"
+#include <cmath>
 #include <string>
 #include <sstream>
 using std::endl;
@@ -35,6 +36,7 @@ void PMCRacer::add_all_algs() { algs = PMCAlg::get_all(); }
 */
 void PMCRacer::set_debug() { debug = true; }
 void PMCRacer::unset_debug() { debug = false; }
+void PMCRacer::set_cancellation_token(CancellationTokenPtr t) { cancellation = t; }
 
 bool PMCRacer::go(const StatisticRequest& sr, bool verbose) {
 
@@ -54,16 +56,21 @@ bool PMCRacer::go(const StatisticRequest& sr, bool verbose) {
         // separators, start by calculating them in advance. Add the time required to
         // the total time.
         // To enforce the time limit, calculate the separators one by one.
-        time_t start_time = time(NULL);
+        // The enumerators of all algorithms share one copy of the graph.
+        CancellationToken ms_token(cancellation);
+        if (sr.test_time_limit_pmc()) {
+            ms_token.setTimeLimit(sr.get_time_limit_pmc());
+        }
         bool time_limit_exceeded = false;
-        MinimalSeparatorsEnumerator mse(gs[i].get_graph(), UNIFORM);
+        GraphPtr graph = make_shared<const Graph>(gs[i].get_graph());
+        MinimalSeparatorsEnumerator mse(graph, UNIFORM);
         NodeSetSet min_seps;
-        time_t ms_calc_time=0;
+        double ms_calc_time=0;
         try {
             while(mse.hasNext()) {
                 min_seps.insert(mse.next());
-                ms_calc_time = difftime(time(NULL),start_time);
-                if (sr.test_time_limit_pmc() && ms_calc_time > sr.get_time_limit_pmc()) {
+                ms_calc_time = ms_token.getElapsedSeconds();
+                if (ms_token.isCancelled()) {
                     time_limit_exceeded = true;
                     break;
                 }
@@ -72,15 +79,15 @@ bool PMCRacer::go(const StatisticRequest& sr, bool verbose) {
         catch(std::bad_alloc) {
             TRACE(TRACE_LVL__ERROR, "Out of memory calculating minimal separators...");
             gs[i].set_mem_error_ms();
-            gs[i].set_pmc_calc_time(algs, ms_calc_time);
+            gs[i].set_pmc_calc_time(algs, llround(ms_calc_time));
             continue;
         }
 
         // Keep calculating. Now, the remaining time can be used by each algorithm
         // separately.
-        UTILS__PRINT_IF(verbose, "MS calc time: " << utils__timestamp_to_hhmmss(ms_calc_time));
+        UTILS__PRINT_IF(verbose, "MS calc time: " << utils__timestamp_to_hhmmss(llround(ms_calc_time)));
         // time_remaining may be garbage if sr.test_time_limit_pmc() == false
-        time_t time_remaining_for_pmcs = difftime(sr.get_time_limit_pmc(true),ms_calc_time);
+        double time_remaining_for_pmcs = sr.get_time_limit_pmc(true) - ms_calc_time;
         if (time_remaining_for_pmcs <= 0) {
             time_remaining_for_pmcs = 1;
         }
@@ -119,18 +126,19 @@ bool PMCRacer::go(const StatisticRequest& sr, bool verbose) {
             UTILS__PRINT_IF(verbose,"New iteration, alg = " << alg.str());
 
             // Calculate PMCs
-            PMCEnumerator pmce(gs[i].get_graph());
+            PMCEnumerator pmce(graph);
             TRACE(TRACE_LVL__TEST, "Set algorithm for the PMCE");
             pmce.set_algorithm(alg);
             NodeSetSet pmcs;
-            time_t inner_start_time = time(NULL);
+            CancellationTokenPtr pmc_token = make_shared<CancellationToken>(cancellation);
+            if (sr.test_time_limit_pmc()) {
+                pmc_token->setTimeLimit(time_remaining_for_pmcs);
+            }
+            pmce.set_cancellation_token(pmc_token);
             try {
                 if (gs[i].get_graph().getNumberOfNodes() > 0) {
                     pmce.set_minimal_separators(min_seps);
                 }
-                if (sr.test_time_limit_pmc()) {
-                    pmce.set_time_limit(time_remaining_for_pmcs);
-                }
                 pmcs = pmce.get(/*sr*/);
             }
             catch (std::bad_alloc) {
@@ -138,8 +146,9 @@ bool PMCRacer::go(const StatisticRequest& sr, bool verbose) {
                 gs[i].set_mem_error_pmc(alg);
                 continue;
             }
-            time_t pmc_calc_time_without_ms = difftime(time(NULL), inner_start_time);
-            time_t pmc_calc_time_with_ms = pmc_calc_time_without_ms + ms_calc_time;
+            // The times are kept exact until stored, in whole seconds
+            double pmc_calc_time_without_ms = pmc_token->getElapsedSeconds();
+            time_t pmc_calc_time_with_ms = llround(pmc_calc_time_without_ms + ms_calc_time);
             TRACE(TRACE_LVL__TEST, "Ran PMCE, total (including MS) is " << utils__timestamp_to_hhmmss(pmc_calc_time_with_ms));
 
             // Error checking
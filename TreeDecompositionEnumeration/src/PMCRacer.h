@@ -38,6 +38,10 @@ private:
     // Flag for debugging (inner crosscheck functionality)
     bool debug;
 
+    // Stops the race when cancelled (may be NULL). Every graph and every
+    // algorithm gets a token derived from it, with the time limit.
+    CancellationTokenPtr cancellation;
+
     // The algorithms to use
 //    vector<PMCAlg> algs;
 
@@ -72,6 +76,10 @@ public:
     void set_debug();
     void unset_debug();
 
+    // Stops the race once the token is cancelled, as if the time limit of
+    // the current graph was reached
+    void set_cancellation_token(CancellationTokenPtr);
+
     // Race! Optionally, print stuff to console.
     // If append_results is set to true, results will be appended
     // as new rows in the CSV file.
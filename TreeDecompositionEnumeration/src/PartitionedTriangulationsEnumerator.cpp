@@ -0,0 +1,272 @@
+#include "PartitionedTriangulationsEnumerator.h"
+#include "MinimalSeparatorsEnumerator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <omp.h>
+
+namespace tdenum {
+
+// Above this many parts per thread, the search is not split
+#define PARTITION_PARTS_PER_THREAD 2
+
+/*
+ * Checks whether the nodes of t are in different components of the graph
+ * obtained by removing s, given the components map of s.
+ */
+static bool isCrossing(const vector<int>& componentsMapOfS, const MinimalSeparator& t) {
+	int componentContainingT = 0;
+	for (MinimalSeparator::const_iterator it = t.begin(); it != t.end(); ++it) {
+		int componentContainingCurrentNode = componentsMapOfS[*it];
+		if (componentContainingCurrentNode == -1
+				|| componentContainingCurrentNode == componentContainingT) {
+			continue;
+		} else if (componentContainingT == 0) {
+			componentContainingT = componentContainingCurrentNode;
+		} else {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ * Initialization. The split is left to the first call to hasNext().
+ */
+PartitionedTriangulationsEnumerator::PartitionedTriangulationsEnumerator(
+			Graph g, TriangulationScoringCriterion triC,
+			SeparatorsScoringCriterion sepC, TriangulationAlgorithm heuristic,
+			CancellationTokenPtr cancellation) :
+		graph(make_shared<const Graph>(move(g))), triC(triC), sepC(sepC),
+		heuristic(heuristic), threads(omp_get_max_threads()),
+		cancellation(cancellation), partitioned(false),
+		numberOfSeparators(0), nextPart(0), resultsPerRound(1),
+		extensionsReused(0), extensionsComputed(0) {}
+
+PartitionedTriangulationsEnumerator::~PartitionedTriangulationsEnumerator() {
+	for (unsigned int i=0; i<running.size(); i++) {
+		delete running[i];
+	}
+}
+
+/*
+ * Splits by the candidate separator whose number of parts is closest to the
+ * number of threads, preferring fewer parts. The crossings of the candidates
+ * are counted while the separators are generated, and if every candidate
+ * gives too many parts, the generation stops and the search is not split.
+ */
+void PartitionedTriangulationsEnumerator::partition() {
+	partitioned = true;
+	running.resize(threads, NULL);
+	runningPart.resize(threads, -1);
+	int maxCrossing = PARTITION_PARTS_PER_THREAD * threads - 1;
+	vector<MinimalSeparator> separators;
+	vector< vector<int> > componentsMaps;
+	vector< vector<int> > crossing;
+	MinimalSeparatorsEnumerator separatorsEnumerator(graph, sepC);
+	bool tooManyParts = false;
+	while (!tooManyParts && separatorsEnumerator.hasNext()) {
+		if (cancellation && cancellation->poll()) {
+			return;
+		}
+		int j = separators.size();
+		separators.push_back(separatorsEnumerator.next());
+		if (j < PARTITION_SEPARATOR_CANDIDATES) {
+			componentsMaps.push_back(graph->getComponentsMap(separators[j]));
+			crossing.push_back(vector<int>());
+			for (int i=0; i<j; i++) {
+				if (isCrossing(componentsMaps[j], separators[i])) {
+					crossing[j].push_back(i);
+				}
+			}
+		}
+		for (int i=0; i<(int)componentsMaps.size() && i<j; i++) {
+			if (isCrossing(componentsMaps[i], separators[j])) {
+				crossing[i].push_back(j);
+			}
+		}
+		if (componentsMaps.size() == PARTITION_SEPARATOR_CANDIDATES) {
+			tooManyParts = true;
+			for (unsigned int i=0; i<crossing.size(); i++) {
+				tooManyParts = tooManyParts && (int)crossing[i].size() > maxCrossing;
+			}
+		}
+	}
+	numberOfSeparators = separators.size();
+	int chosen = -1;
+	for (int i=0; !tooManyParts && i<(int)crossing.size(); i++) {
+		if ((int)crossing[i].size() > maxCrossing) {
+			continue;
+		}
+		int distance = abs((int)crossing[i].size() - (threads-1));
+		int distanceChosen = chosen == -1 ? 0 : abs((int)crossing[chosen].size() - (threads-1));
+		if (chosen == -1 || distance < distanceChosen || (distance == distanceChosen
+				&& crossing[i].size() < crossing[chosen].size())) {
+			chosen = i;
+		}
+	}
+	if (chosen == -1) {
+		// A single part, the graph itself
+		included.push_back(MinimalSeparator());
+		excluded.push_back(vector<MinimalSeparator>());
+		return;
+	}
+	included.push_back(separators[chosen]);
+	excluded.push_back(vector<MinimalSeparator>());
+	for (unsigned int j=0; j<crossing[chosen].size(); j++) {
+		const MinimalSeparator& current = separators[crossing[chosen][j]];
+		vector<int> componentsMap = graph->getComponentsMap(current);
+		vector<MinimalSeparator> parallelBefore;
+		for (unsigned int i=0; i<j; i++) {
+			if (!isCrossing(componentsMap, separators[crossing[chosen][i]])) {
+				parallelBefore.push_back(separators[crossing[chosen][i]]);
+			}
+		}
+		included.push_back(current);
+		excluded.push_back(parallelBefore);
+	}
+}
+
+void PartitionedTriangulationsEnumerator::stopPart(int thread) {
+	numberOfSeparators = max(numberOfSeparators,
+			running[thread]->getNumberOfMinimalSeperatorsGenerated());
+	extensionsReused += running[thread]->getNumberOfExtensionsReused();
+	extensionsComputed += running[thread]->getNumberOfExtensionsComputed();
+	delete running[thread];
+	running[thread] = NULL;
+	runningPart[thread] = -1;
+}
+
+/*
+ * The parts are assigned to the free threads in order, and initialized by the
+ * thread running them.
+ */
+void PartitionedTriangulationsEnumerator::runRound() {
+	for (int t=0; t<threads; t++) {
+		if (runningPart[t] == -1 && nextPart < (int)included.size()) {
+			runningPart[t] = nextPart++;
+		}
+	}
+	vector< vector<ChordalGraph> > produced(threads);
+	vector<int> finished(threads, 0);
+	#pragma omp parallel for schedule(dynamic) num_threads(threads)
+	for (int t=0; t<threads; t++) {
+		int part = runningPart[t];
+		if (part == -1) {
+			continue;
+		}
+		if (!running[t]) {
+			Graph saturatedGraph = *graph;
+			saturatedGraph.addClique(included[part]);
+			running[t] = new MinimalTriangulationsEnumerator(move(saturatedGraph),
+					triC, sepC, heuristic);
+			running[t]->setCancellationToken(cancellation);
+			running[t]->setExcludedSeparators(excluded[part]);
+		}
+		while ((int)produced[t].size() < resultsPerRound && running[t]->hasNext()) {
+			produced[t].push_back(running[t]->next());
+		}
+		finished[t] = (int)produced[t].size() < resultsPerRound;
+	}
+	// Returns the results in the order of the parts
+	vector< pair<int,int> > order;
+	for (int t=0; t<threads; t++) {
+		if (runningPart[t] != -1) {
+			order.push_back(make_pair(runningPart[t], t));
+		}
+	}
+	sort(order.begin(), order.end());
+	for (unsigned int i=0; i<order.size(); i++) {
+		int t = order[i].second;
+		resultsReady.insert(resultsReady.end(), produced[t].begin(), produced[t].end());
+		if (finished[t]) {
+			stopPart(t);
+		}
+	}
+	resultsPerRound = min(2*resultsPerRound, PARTITION_RESULTS_PER_ROUND);
+}
+
+/*
+ * Checks whether there is another minimal triangulation
+ */
+bool PartitionedTriangulationsEnumerator::hasNext() {
+	if (!partitioned) {
+		partition();
+	}
+	while (resultsReady.empty()) {
+		if (isCancelled()) {
+			return false;
+		}
+		bool allDone = nextPart == (int)included.size();
+		for (int t=0; t<threads; t++) {
+			allDone = allDone && runningPart[t] == -1;
+		}
+		if (allDone) {
+			return false;
+		}
+		runRound();
+	}
+	return true;
+}
+
+/*
+ * Returns another minimal triangulation
+ */
+ChordalGraph PartitionedTriangulationsEnumerator::next() {
+	if (!hasNext()) {
+		return ChordalGraph();
+	}
+	ChordalGraph triangulation = resultsReady.front();
+	resultsReady.pop_front();
+	return triangulation;
+}
+
+void PartitionedTriangulationsEnumerator::setNumberOfThreads(int threads) {
+	this->threads = max(threads, 1);
+}
+
+void PartitionedTriangulationsEnumerator::setCancellationToken(CancellationTokenPtr token) {
+	cancellation = token;
+	for (unsigned int i=0; i<running.size(); i++) {
+		if (running[i]) {
+			running[i]->setCancellationToken(token);
+		}
+	}
+}
+
+int PartitionedTriangulationsEnumerator::getNumberOfParts() {
+	return included.size();
+}
+
+/*
+ * If the search was not split, the generation of the separators may have been
+ * stopped early, and the part generates them all.
+ */
+int PartitionedTriangulationsEnumerator::getNumberOfMinimalSeperatorsGenerated() {
+	int separators = numberOfSeparators;
+	if (included.size() == 1 && running[0]) {
+		separators = max(separators, running[0]->getNumberOfMinimalSeperatorsGenerated());
+	}
+	return separators;
+}
+
+long long PartitionedTriangulationsEnumerator::getNumberOfExtensionsReused() {
+	long long reused = extensionsReused;
+	for (unsigned int i=0; i<running.size(); i++) {
+		if (running[i]) {
+			reused += running[i]->getNumberOfExtensionsReused();
+		}
+	}
+	return reused;
+}
+
+long long PartitionedTriangulationsEnumerator::getNumberOfExtensionsComputed() {
+	long long computed = extensionsComputed;
+	for (unsigned int i=0; i<running.size(); i++) {
+		if (running[i]) {
+			computed += running[i]->getNumberOfExtensionsComputed();
+		}
+	}
+	return computed;
+}
+
+} /* namespace tdenum */
@@ -0,0 +1,99 @@
+#ifndef PARTITIONEDTRIANGULATIONSENUMERATOR_H_
+#define PARTITIONEDTRIANGULATIONSENUMERATOR_H_
+
+#include "MinimalTriangulationsEnumerator.h"
+#include <deque>
+
+namespace tdenum {
+
+// How many generated minimal separators are considered for splitting the search
+#define PARTITION_SEPARATOR_CANDIDATES 16
+// The most triangulations each running part produces per round. The first
+// round asks for one, and every round doubles it up to this.
+#define PARTITION_RESULTS_PER_ROUND 8
+
+/**
+ * Enumerates the minimal triangulations of a graph by splitting them into
+ * disjoint parts that are enumerated independently, in parallel.
+ *
+ * A minimal separator S is chosen, and C_1,...,C_k are the minimal separators
+ * crossing it. Every minimal triangulation either contains S, or contains some
+ * C_j, and the parts are:
+ * P_0 - the triangulations containing S.
+ * P_j - the triangulations containing C_j and none of C_1,...,C_{j-1}.
+ * The minimal triangulations containing a minimal separator are the minimal
+ * triangulations of the graph in which it is saturated, so every part is
+ * enumerated by its own MinimalTriangulationsEnumerator, which skips the
+ * triangulations containing an excluded separator. Only the C_i parallel to
+ * C_j are excluded, as the others are not minimal separators once C_j is
+ * saturated.
+ *
+ * S is chosen so that there are about as many parts as threads, and the
+ * search is not split if every candidate gives many more. No more parts than
+ * threads run at once, and a part is only initialized once a thread is free
+ * for it. The split is made by the first call to hasNext(), so it can be
+ * cancelled by the token.
+ *
+ * Each round, the parts running produce a few results in parallel, which are
+ * returned in the order of the parts, so the output is deterministic.
+ */
+class PartitionedTriangulationsEnumerator {
+	GraphPtr graph;
+	TriangulationScoringCriterion triC;
+	SeparatorsScoringCriterion sepC;
+	TriangulationAlgorithm heuristic;
+	int threads;
+	CancellationTokenPtr cancellation;
+	bool partitioned;
+	int numberOfSeparators;
+	// The saturated separator and the separators excluded by every part
+	vector<MinimalSeparator> included;
+	vector< vector<MinimalSeparator> > excluded;
+	// The parts running, one per thread (NULL if none), and their indices
+	vector<MinimalTriangulationsEnumerator*> running;
+	vector<int> runningPart;
+	int nextPart;
+	int resultsPerRound;
+	long long extensionsReused;
+	long long extensionsComputed;
+	deque<ChordalGraph> resultsReady;
+	bool isCancelled() const { return cancellation && cancellation->isCancelled(); }
+	// Chooses the separator to split by, and the parts
+	void partition();
+	// Stops a running part, keeping its counters
+	void stopPart(int thread);
+	// Lets every running part produce more results, starting new parts on
+	// the threads that are free
+	void runRound();
+	// The parts are owned, so copying is not allowed
+	PartitionedTriangulationsEnumerator(const PartitionedTriangulationsEnumerator&);
+	PartitionedTriangulationsEnumerator& operator=(const PartitionedTriangulationsEnumerator&);
+public:
+	// initialization
+	PartitionedTriangulationsEnumerator(Graph g, TriangulationScoringCriterion triC,
+			SeparatorsScoringCriterion sepC, TriangulationAlgorithm heuristic,
+			CancellationTokenPtr cancellation = CancellationTokenPtr());
+	~PartitionedTriangulationsEnumerator();
+	// Checks whether there is another minimal triangulation
+	bool hasNext();
+	// Returns another minimal triangulation
+	ChordalGraph next();
+	// Sets how many parts run in parallel (omp_get_max_threads() by default).
+	// Must be called before the first hasNext().
+	void setNumberOfThreads(int threads);
+	// Stops the split and the enumeration of every part once the token is
+	// cancelled
+	void setCancellationToken(CancellationTokenPtr token);
+	// Returns the number of parts the search was split into
+	int getNumberOfParts();
+	// Returns the number of minimal separators of the graph
+	int getNumberOfMinimalSeperatorsGenerated();
+	// Returns how many set extensions were reused, and how many were computed,
+	// summed over the parts
+	long long getNumberOfExtensionsReused();
+	long long getNumberOfExtensionsComputed();
+};
+
+} /* namespace tdenum */
+
+#endif /* PARTITIONEDTRIANGULATIONSENUMERATOR_H_ */
@@ -0,0 +1,78 @@
+#include "PrefixGraph.h"
+#include <algorithm>
+
+namespace tdenum {
+
+PrefixGraph::PrefixGraph(const Graph& g) :
+		graph(&g), size(g.getNumberOfNodes()) {}
+
+PrefixGraph::PrefixGraph(const Graph& g, int size) :
+		graph(&g), size(size) {}
+
+/*
+ * With the bit-matrix, counts the bits of the row below size. Otherwise, the
+ * neighbor set is sorted, so the neighbors in the prefix come first.
+ */
+int PrefixGraph::d(Node v) const {
+	if (graph->getAdjacency() == ADJACENCY_BITSET) {
+		const BitWord* row = graph->getNeighborWords(v);
+		int words = getNumberOfNeighborWords();
+		int degree = 0;
+		for (int w=0; w<words; w++) {
+			BitWord word = row[w];
+			if (w == words-1 && size % BITWORD_BITS) {
+				word &= (1ULL << (size % BITWORD_BITS)) - 1;
+			}
+			degree += __builtin_popcountll(word);
+		}
+		return degree;
+	}
+	const set<Node>& neighbors = graph->getNeighbors(v);
+	return distance(neighbors.begin(), neighbors.lower_bound(size));
+}
+
+vector<NodeSet> PrefixGraph::getComponents(const NodeSet& removedNodes) const {
+	BlocksWorkspace ws;
+	const FlatBlockVec& blocks = getBlocks(removedNodes, ws);
+	vector<NodeSet> components;
+	for (unsigned int i=0; i<blocks.size(); i++) {
+		components.push_back(blocks.C(i).toNodeSet());
+	}
+	return components;
+}
+
+/*
+ * Only the neighbors of S matter, and they are all in the prefix.
+ */
+bool PrefixGraph::isFullComponent(const NodeSet& C, const NodeSet& S) const {
+	return graph->isFullComponent(C, S);
+}
+
+Graph PrefixGraph::toGraph() const {
+	Graph g(size, graph->getAdjacency());
+	for (Node v=0; v<size; v++) {
+		const set<Node>& neighbors = graph->getNeighbors(v);
+		for (set<Node>::const_iterator it = neighbors.upper_bound(v);
+				it != neighbors.end() && *it < size; ++it) {
+			g.addEdge(v, *it);
+		}
+	}
+	return g;
+}
+
+ostream& operator<<(ostream& os, const PrefixGraph& g) {
+	for (Node v=0; v<g.size; v++) {
+		const set<Node>& neighbors = g.graph->getNeighbors(v);
+		os << v << " has neighbors: {";
+		bool first = true;
+		for (set<Node>::const_iterator it = neighbors.begin();
+				it != neighbors.end() && *it < g.size; ++it) {
+			os << (first ? "" : ",") << *it;
+			first = false;
+		}
+		os << "}" << endl;
+	}
+	return os;
+}
+
+} /* namespace tdenum */
@@ -0,0 +1,49 @@
+#ifndef PREFIXGRAPH_H_
+#define PREFIXGRAPH_H_
+
+#include "Graph.h"
+
+namespace tdenum {
+
+/**
+ * A view of the subgraph of a graph induced by its first nodes, 0..size-1.
+ * Nothing is copied: the queries of the graph are answered on the fly, leaving
+ * out the nodes of larger rank, so one renamed graph stands for the whole
+ * chain of subgraphs G_1 < G_2 < ... < G_n.
+ *
+ * The graph must outlive the view. Node sets passed to the view are assumed to
+ * be in the prefix.
+ */
+class PrefixGraph {
+	const Graph* graph;
+	int size;
+public:
+	// The whole graph
+	PrefixGraph(const Graph& g);
+	// The subgraph of the first size nodes of g
+	PrefixGraph(const Graph& g, int size);
+	const Graph& getBase() const { return *graph; }
+	int getNumberOfNodes() const { return size; }
+	AdjacencyBackend getAdjacency() const { return graph->getAdjacency(); }
+	// Returns the number of neighbors of v in the prefix
+	int d(Node v) const;
+	bool areNeighbors(Node u, Node v) const { return graph->areNeighbors(u,v); }
+	// With ADJACENCY_BITSET, returns the row of v in the bit-matrix. Only its
+	// first getNumberOfNeighborWords() words cover the prefix, and the bits of
+	// the last one past the prefix must be masked by the caller.
+	const BitWord* getNeighborWords(Node v) const { return graph->getNeighborWords(v); }
+	int getNumberOfNeighborWords() const { return BitMatrix::wordsFor(size); }
+	// Same as in Graph, in the subgraph
+	vector<NodeSet> getComponents(const NodeSet& removedNodes) const;
+	bool isFullComponent(const NodeSet& C, const NodeSet& S) const;
+	const FlatBlockVec& getBlocks(const NodeSet& removedNodes, BlocksWorkspace& ws) const {
+		return graph->getBlocks(removedNodes, ws, size);
+	}
+	// Returns a copy of the subgraph, for algorithms that need a Graph
+	Graph toGraph() const;
+	friend ostream& operator<<(ostream&, const PrefixGraph&);
+};
+
+} /* namespace tdenum */
+
+#endif /* PREFIXGRAPH_H_ */
@@ -9,7 +9,7 @@
 #define RESULTSHANDLER_H_
 
 #include <ostream>
-#include <ctime>
+#include <chrono>
 using namespace std;
 
 namespace tdenum {
@@ -24,9 +24,10 @@ public:
 	ResultInformation() : number(0), time(0), fill(0), width(0), expBagSize(0) {}
 	ResultInformation(int index, double time, const Graph& input, const ChordalGraph& result) :
 			number(index), time(time) {
-		fill = result.getFillIn(input);
-		width = result.getTreeWidth();
-		expBagSize = result.getExpBagsSize();
+		CliqueTree cliqueTree = result.getCliqueTreeMeasures(input);
+		fill = cliqueTree.fill;
+		width = cliqueTree.width;
+		expBagSize = cliqueTree.expBagsSize;
 	}
 	int getTime() { return time; }
 	int getFill() { return fill; }
@@ -52,7 +53,7 @@ class ResultsHandler {
 	Graph graph;
 	ostream& output;
 	WhenToPrint whenToPrint;
-	clock_t startTime;
+	chrono::steady_clock::time_point startTime;
 	ResultInformation firstResult;
 	ResultInformation minWidthResult;
 	ResultInformation minFillResult;
@@ -65,7 +66,7 @@ class ResultsHandler {
 	int goodWidthCount, goodFillCount; // good = at least as good as the first one
 	int resultsFound;
 	double getTime() {
-		return double(clock() - startTime) / CLOCKS_PER_SEC;
+		return chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
 	}
 public:
 	ResultsHandler(const Graph& g, ostream& o, WhenToPrint p) :
@@ -73,7 +74,7 @@ public:
 				minWidth(0), maxWidth(0), minFill(0), maxFill(0), minBagExpSize(0),
 				maxBagExpSize(0), firstWidth(0), firstFill(0), minWidthCount(0),
 				minFillCount(0), goodWidthCount(0), goodFillCount(0), resultsFound(0) {
-		startTime = clock();
+		startTime = chrono::steady_clock::now();
 	}
 	void newResult(const ChordalGraph& triangulation) {
 		ResultInformation currentResult(++resultsFound, getTime(), graph, triangulation);
@@ -3,27 +3,71 @@
 
 namespace tdenum {
 
-SeparatorGraph::SeparatorGraph(const Graph& g, SeparatorsScoringCriterion c) :
-		graph(g), nodesEnumerator(g, c), nodesGenerated(0) {}
+SeparatorGraph::SeparatorGraph(GraphPtr g, SeparatorsScoringCriterion c, NodeSetPool& pool) :
+		graph(g), separators(pool), nodesEnumerator(graph, c), nodesGenerated(0),
+		maxCachedMaps(0) {
+	int n = graph->getNumberOfNodes();
+	if (n < (1 << (8*sizeof(ComponentLabel)))) {
+		maxCachedMaps = max(1, SEPARATOR_GRAPH_CACHE_BYTES / (int)(max(n,1)*sizeof(ComponentLabel)));
+	}
+}
 
 bool SeparatorGraph::hasNextNode() {
 	return nodesEnumerator.hasNext();
 }
 
-MinimalSeparator SeparatorGraph::nextNode() {
+NodeSetId SeparatorGraph::nextNode() {
 	nodesGenerated++;
-	return nodesEnumerator.next();
+	return separators.intern(nodesEnumerator.next());
 }
 
-// check if the nodes of v are in different components of the graph obtained by removing u
-bool SeparatorGraph::hasEdge(const MinimalSeparator& s, const MinimalSeparator& t) {
-	vector<int> componentsMap = graph.getComponentsMap(s);
-	int componentContainingT = 0;
+/*
+ * A cache miss reuses the map of the least recently used separator once the
+ * cache is full.
+ */
+const vector<ComponentLabel>& SeparatorGraph::getComponentsMap(NodeSetId id) {
+	if (cacheIndexOf.size() <= id) {
+		cacheIndexOf.resize(separators.size(), -1);
+	}
+	int index = cacheIndexOf[id];
+	if (index >= 0) {
+		recentlyUsed.splice(recentlyUsed.begin(), recentlyUsed, recentlyUsedPosition[index]);
+		return cachedMaps[index];
+	}
+	if (cachedMaps.size() < maxCachedMaps) {
+		index = cachedMaps.size();
+		cachedMaps.push_back(vector<ComponentLabel>());
+		cachedIds.push_back(id);
+		recentlyUsed.push_front(index);
+		recentlyUsedPosition.push_back(recentlyUsed.begin());
+	} else {
+		index = recentlyUsed.back();
+		cacheIndexOf[cachedIds[index]] = -1;
+		cachedIds[index] = id;
+		recentlyUsed.splice(recentlyUsed.begin(), recentlyUsed, recentlyUsedPosition[index]);
+	}
+	cacheIndexOf[id] = index;
+	vector<int> componentsMap = graph->getComponentsMap(separators.get(id));
+	vector<ComponentLabel>& labels = cachedMaps[index];
+	labels.resize(componentsMap.size());
+	for (unsigned int v=0; v<componentsMap.size(); v++) {
+		labels[v] = componentsMap[v] < 0 ? 0 : componentsMap[v];
+	}
+	return labels;
+}
+
+/*
+ * Returns true if the nodes of t not in the separator of the map meet at least
+ * two of its components. The separator is labeled by non-positive labels.
+ */
+template<class Label>
+static bool meetsTwoComponents(const vector<Label>& componentsMap, const MinimalSeparator& t) {
+	Label componentContainingT = 0;
 	for (MinimalSeparator::const_iterator it = t.begin(); it != t.end(); ++it) {
-		int componentContainingCurrentNode = componentsMap[*it];
+		Label componentContainingCurrentNode = componentsMap[*it];
 		if (componentContainingT == componentContainingCurrentNode) {
 			continue;
-		} else if (componentContainingCurrentNode == -1) {
+		} else if (componentContainingCurrentNode <= 0) {
 			continue;
 		} else if (componentContainingT == 0) {
 			componentContainingT = componentContainingCurrentNode;
@@ -35,6 +79,15 @@ bool SeparatorGraph::hasEdge(const MinimalSeparator& s, const MinimalSeparator&
 	return false;
 }
 
+// check if the nodes of v are in different components of the graph obtained by removing u
+bool SeparatorGraph::hasEdge(const NodeSetId& sId, const NodeSetId& tId) {
+	const MinimalSeparator& t = separators.get(tId);
+	if (maxCachedMaps == 0) {
+		return meetsTwoComponents(graph->getComponentsMap(separators.get(sId)), t);
+	}
+	return meetsTwoComponents(getComponentsMap(sId), t);
+}
+
 int SeparatorGraph::getNumberOfNodesGenerated() {
 	return nodesGenerated;
 }
@@ -2,27 +2,49 @@
 #define SEPARATORGRAPH_H_
 #include "MinimalSeparatorsEnumerator.h"
 #include "SuccinctGraphRepresentation.h"
+#include <list>
 
 namespace tdenum {
 
+// How many bytes the cached components maps of the separators may take
+#define SEPARATOR_GRAPH_CACHE_BYTES (64 << 20)
+
+// A component of a node in a cached components map, 0 for the separator
+typedef unsigned short ComponentLabel;
+
 /**
  * A polynomial succinct graph representation of a separator graph;
  * A node for every minimal separator of the provided graph,
  * An edge appears between two minimal separators if they are crossing.
+ * The nodes are the IDs of the minimal separators in the given pool.
  */
-class SeparatorGraph : public SuccinctGraphRepresentation<MinimalSeparator> {
-	Graph graph;
+class SeparatorGraph : public SuccinctGraphRepresentation<NodeSetId> {
+	GraphPtr graph;
+	NodeSetPool& separators;
 	MinimalSeparatorsEnumerator nodesEnumerator;
 	int nodesGenerated;
+	// The components maps of the separators queried last, at most
+	// SEPARATOR_GRAPH_CACHE_BYTES of them. The least recently used map is
+	// evicted first. Graphs with too many nodes for ComponentLabel are not
+	// cached.
+	vector< vector<ComponentLabel> > cachedMaps;
+	vector<NodeSetId> cachedIds; // The separator of every cached map
+	vector<int> cacheIndexOf; // Indexed by separator ID, -1 if not cached
+	list<int> recentlyUsed; // Indices of cached maps, most recent first
+	vector<list<int>::iterator> recentlyUsedPosition;
+	unsigned int maxCachedMaps;
+	// Returns the components map of the separator, computing it if it is not
+	// cached
+	const vector<ComponentLabel>& getComponentsMap(NodeSetId id);
 public:
 	// Initialization
-	SeparatorGraph(const Graph& g, SeparatorsScoringCriterion c);
+	SeparatorGraph(GraphPtr g, SeparatorsScoringCriterion c, NodeSetPool& pool);
 	// Checks whether there is another minimal separator
 	virtual bool hasNextNode();
 	// Returns another minimal separator
-	virtual MinimalSeparator nextNode();
+	virtual NodeSetId nextNode();
 	// Checks whether the minimal separators are crossing
-	virtual bool hasEdge(const MinimalSeparator& u, const MinimalSeparator& v);
+	virtual bool hasEdge(const NodeSetId& u, const NodeSetId& v);
 	// Returns how many nodes were already generated
 	int getNumberOfNodesGenerated();
 };
@@ -3,7 +3,7 @@
 namespace tdenum {
 
 SeparatorsScorer::SeparatorsScorer(
-		const Graph& g, SeparatorsScoringCriterion c) : graph(g), criterion(c){}
+		GraphPtr g, SeparatorsScoringCriterion c) : graph(g), criterion(c){}
 
 SeparatorsScorer::~SeparatorsScorer() {}
 
@@ -16,7 +16,7 @@ int SeparatorsScorer::scoreSeparator(const MinimalSeparator& s) {
 		int fill_edges = 0;
 		for (MinimalSeparator::const_iterator it=s.begin(); it!=s.end(); ++it) {
 			for (MinimalSeparator::const_iterator jt=s.begin(); jt!=it; ++jt) {
-				if (!graph.areNeighbors(*it, *jt)) {
+				if (!graph->areNeighbors(*it, *jt)) {
 					fill_edges++;
 				}
 			}
@@ -8,10 +8,10 @@ namespace tdenum {
 enum SeparatorsScoringCriterion { UNIFORM, ASCENDING_SIZE, FILL_EDGES };
 
 class SeparatorsScorer {
-	Graph graph;
+	GraphPtr graph;
 	SeparatorsScoringCriterion criterion;
 public:
-	SeparatorsScorer(const Graph& g, SeparatorsScoringCriterion c);
+	SeparatorsScorer(GraphPtr g, SeparatorsScoringCriterion c);
 	virtual ~SeparatorsScorer();
 	int scoreSeparator(const MinimalSeparator& s);
 };
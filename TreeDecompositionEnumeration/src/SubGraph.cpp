@@ -115,7 +115,7 @@ namespace tdenum {
 	}
 
 	SubGraph::SubGraph(const SubGraph& fatherGraph, NodeSet nodeSetInFatherGraph) :
-		Graph(nodeSetInFatherGraph.size()), mainGraph(fatherGraph.mainGraph) {
+		Graph(nodeSetInFatherGraph.size(), fatherGraph.getAdjacency()), mainGraph(fatherGraph.mainGraph) {
 
 		// father in main
 		const vector<int>& fatherNodesMapInMain = fatherGraph.nodeMapToMainGraph;
@@ -205,18 +205,21 @@ namespace tdenum {
 			removedNodesSub.insert(nodeMapFromMainGraph.at(*n));
 
 		// Calculate SubGraph blocks
-		BlockVec subBlocks = getBlocks(removedNodesSub.produce());
+		BlocksWorkspace ws;
+		const FlatBlockVec& subBlocks = getBlocks(removedNodesSub.produce(), ws);
 
-		// Translate blocks to Main indexes
+		// Translate blocks to Main indexes. The mapping isn't necessarily
+		// monotone, so sort the translated sets.
 		BlockVec mainBlocks(subBlocks.size());
 		for (unsigned int i = 0; i < subBlocks.size(); i++) {
-		//for (auto b = subBlocks.begin(); b != subBlocks.end(); b++) {
-			NodeSetProducer mainS(mainGraph.getNumberOfNodes()), mainC(mainGraph.getNumberOfNodes());
-			for (auto n = subBlocks[i]->S.begin(); n != subBlocks[i]->S.end(); n++)
-				mainS.insert(nodeMapToMainGraph.at(*n));
-			for (auto n = subBlocks[i]->C.begin(); n != subBlocks[i]->C.end(); n++)
-				mainC.insert(nodeMapToMainGraph.at(*n));
-			mainBlocks[i] = BlockPtr(new Block(mainS.produce(), mainC.produce(),mainGraph.getNumberOfNodes()));
+			NodeSet mainS, mainC;
+			for (Node n : subBlocks.S(i))
+				mainS.push_back(nodeMapToMainGraph.at(n));
+			for (Node n : subBlocks.C(i))
+				mainC.push_back(nodeMapToMainGraph.at(n));
+			std::sort(mainS.begin(), mainS.end());
+			std::sort(mainC.begin(), mainC.end());
+			mainBlocks[i] = BlockPtr(new Block(mainS, mainC, mainGraph.getNumberOfNodes()));
 		}
 		return mainBlocks;
 	}
@@ -67,6 +67,7 @@ int main(int argc, char** argv) {
             .set_GraphStatsTester()
             .set_GraphProducerTester()
             .set_PMCEnumeratorTester()
+            .set_TriangulationsTester()
             .set_StatisticRequestTester()
             .set_PMCRacerTester()
             .set_DatasetTester()
@@ -9,6 +9,7 @@
 #include "PMCRacerTester.h"
 #include "StatisticRequestTester.h"
 #include "TestInterface.h"
+#include "TriangulationsTester.h"
 #include "UtilsTester.h"
 
 namespace tdenum {
@@ -27,6 +28,7 @@ namespace tdenum {
     X(GraphStatsTester) \
     X(GraphProducerTester) \
     X(PMCEnumeratorTester) \
+    X(TriangulationsTester) \
     X(StatisticRequestTester) \
     X(PMCRacerTester) \
     X(DatasetTester)
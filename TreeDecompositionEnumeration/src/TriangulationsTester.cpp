@@ -0,0 +1,340 @@
+#include "AtomsTriangulationsEnumerator.h"
+#include "ChordalGraph.h"
+#include "GraphProducer.h"
+#include "GraphReduction.h"
+#include "MinimalTriangulationsEnumerator.h"
+#include "PMCEnumerator.h"
+#include "PartitionedTriangulationsEnumerator.h"
+#include "TriangulationsTester.h"
+
+namespace tdenum {
+
+TriangulationsTester::TriangulationsTester() :
+    TestInterface("Triangulations Tester")
+    #define X(test) , flag_##test(true)
+    TRIANGULATIONS_TEST_TABLE
+    #undef X
+    {}
+
+#define X(_func) \
+TriangulationsTester& TriangulationsTester::set_##_func() { flag_##_func = true; return *this; } \
+TriangulationsTester& TriangulationsTester::unset__##_func() { flag_##_func = false; return *this; } \
+TriangulationsTester& TriangulationsTester::set_only_##_func() { clear_all(); return set_##_func(); }
+TRIANGULATIONS_TEST_TABLE
+#undef X
+
+TriangulationsTester& TriangulationsTester::go() {
+    #define X(_func) if (flag_##_func) {DO_TEST(_func);}
+    TRIANGULATIONS_TEST_TABLE
+    #undef X
+    return *this;
+}
+TriangulationsTester& TriangulationsTester::set_all() {
+    #define X(_func) flag_##_func = true;
+    TRIANGULATIONS_TEST_TABLE
+    #undef X
+    return *this;
+}
+TriangulationsTester& TriangulationsTester::clear_all() {
+    #define X(_func) flag_##_func = false;
+    TRIANGULATIONS_TEST_TABLE
+    #undef X
+    return *this;
+}
+
+// A triangulation as the neighbor sets of its nodes, so it can be put in a set
+static vector< set<Node> > asNeighborSets(const ChordalGraph& triangulation) {
+    vector< set<Node> > neighborSets;
+    for (Node v=0; v<triangulation.getNumberOfNodes(); ++v) {
+        neighborSets.push_back(triangulation.getNeighbors(v));
+    }
+    return neighborSets;
+}
+
+// The minimal triangulations of g, by the plain enumerator
+static set< vector< set<Node> > > plainTriangulations(const Graph& g) {
+    set< vector< set<Node> > > triangulations;
+    MinimalTriangulationsEnumerator enumerator(g, NONE, UNIFORM, MCS_M);
+    while (enumerator.hasNext()) {
+        triangulations.insert(asNeighborSets(enumerator.next()));
+    }
+    return triangulations;
+}
+
+// Glues two graphs on the edge {0,1}: node v of h is v if v<2, and
+// g.getNumberOfNodes()+v-2 otherwise
+static Graph glueOnEdge(const Graph& g, const Graph& h) {
+    int n = g.getNumberOfNodes();
+    Graph glued(n + h.getNumberOfNodes() - 2);
+    for (Node v=0; v<n; ++v) {
+        for (Node u : g.getNeighbors(v)) {
+            if (v < u) {
+                glued.addEdge(v, u);
+            }
+        }
+    }
+    auto rename = [n](Node v) { return v < 2 ? v : n+v-2; };
+    for (Node v=0; v<h.getNumberOfNodes(); ++v) {
+        for (Node u : h.getNeighbors(v)) {
+            if (v < u) {
+                glued.addEdge(rename(v), rename(u));
+            }
+        }
+    }
+    glued.addEdge(0, 1);
+    return glued;
+}
+
+bool TriangulationsTester::triangulationsthreadorder() const {
+    auto gs = GraphProducer().add_random({8,11,14},{0.3,0.5}, true).get();
+    TriangulationAlgorithm heuristics[] = {MCS_M, COMBINED, MIN_FILL_LB_TRIANG};
+    for (unsigned i=0; i<gs.size(); ++i) {
+        for (TriangulationAlgorithm heuristic : heuristics) {
+            MinimalTriangulationsEnumerator serial(gs[i].get_graph(), FILL, UNIFORM, heuristic);
+            MinimalTriangulationsEnumerator threaded(gs[i].get_graph(), FILL, UNIFORM, heuristic);
+            threaded.setNumberOfThreads(4);
+            vector<ChordalGraph> serialTriangulations = serial.getAll();
+            vector<ChordalGraph> threadedTriangulations = threaded.getAll();
+            ASSERT_EQ(serialTriangulations.size(), threadedTriangulations.size());
+            for (unsigned j=0; j<serialTriangulations.size(); ++j) {
+                ASSERT(serialTriangulations[j] == threadedTriangulations[j]);
+            }
+        }
+    }
+    return true;
+}
+
+bool TriangulationsTester::partitionedtriangulations() const {
+    auto gs = GraphProducer().add_random({8,11,14},{0.3,0.5}, true).get();
+    bool split = false;
+    for (unsigned i=0; i<gs.size(); ++i) {
+        set< vector< set<Node> > > plain = plainTriangulations(gs[i].get_graph());
+        for (int threads : {1, 4}) {
+            set< vector< set<Node> > > partitionedTriangulations;
+            PartitionedTriangulationsEnumerator partitioned(gs[i].get_graph(), NONE, UNIFORM, MCS_M);
+            partitioned.setNumberOfThreads(threads);
+            int count = 0;
+            while (partitioned.hasNext()) {
+                partitionedTriangulations.insert(asNeighborSets(partitioned.next()));
+                ++count;
+            }
+            // The parts are disjoint
+            ASSERT_EQ(count, (int)partitionedTriangulations.size());
+            ASSERT(plain == partitionedTriangulations);
+            split = split || partitioned.getNumberOfParts() > 1;
+        }
+    }
+    ASSERT(split);
+    return true;
+}
+
+bool TriangulationsTester::atomstwocycles() const {
+    // Two 5-cycles sharing the edge {0,1}, which is their clique separator
+    Graph cycle(5);
+    for (Node v=0; v<5; ++v) {
+        cycle.addEdge(v, (v+1)%5);
+    }
+    GraphPtr g = make_shared<const Graph>(glueOnEdge(cycle, cycle));
+    AtomDecomposition decomposition(g);
+    ASSERT_EQ(decomposition.getNumberOfAtoms(), 2);
+    ASSERT_EQ(decomposition.getAtom(0), NodeSet({0,1,2,3,4}));
+    ASSERT_EQ(decomposition.getAtom(1), NodeSet({0,1,5,6,7}));
+    ASSERT_EQ(decomposition.getCliqueMinimalSeparators().size(), (unsigned)1);
+    ASSERT(decomposition.getCliqueMinimalSeparators().count(MinimalSeparator({0,1})));
+    // Every triangulation of a 5-cycle adds two chords
+    AtomsTriangulationsEnumerator enumerator(*g, NONE, UNIFORM, MCS_M);
+    set< vector< set<Node> > > triangulations;
+    while (enumerator.hasNext()) {
+        enumerator.advance();
+        ASSERT_EQ(enumerator.getTreeWidth(), 2);
+        ASSERT_EQ(enumerator.getFillIn(), 4);
+        triangulations.insert(asNeighborSets(enumerator.getTriangulation()));
+    }
+    ASSERT_EQ(triangulations.size(), (unsigned)25);
+    ASSERT(triangulations == plainTriangulations(*g));
+    AtomsTriangulationsEnumerator counter(*g, NONE, UNIFORM, MCS_M);
+    ASSERT_EQ(counter.getNumberOfTriangulations(), 25LL);
+    return true;
+}
+
+bool TriangulationsTester::atomschordal() const {
+    // A 4-clique with a path 3-4-5 hanging from it
+    Graph g(6);
+    set<NodeSet> clique;
+    clique.insert(NodeSet({0,1,2,3}));
+    g.saturateNodeSets(clique);
+    g.addEdge(3,4);
+    g.addEdge(4,5);
+    AtomDecomposition decomposition(make_shared<const Graph>(g));
+    ASSERT_EQ(decomposition.getNumberOfAtoms(), 3);
+    AtomsTriangulationsEnumerator enumerator(g, NONE, UNIFORM, MCS_M);
+    ASSERT(enumerator.hasNext());
+    ASSERT(asNeighborSets(enumerator.next()) == asNeighborSets(ChordalGraph(g)));
+    ASSERT(!enumerator.hasNext());
+    return true;
+}
+
+bool TriangulationsTester::atomsempty() const {
+    Graph g(0);
+    AtomsTriangulationsEnumerator enumerator(g, NONE, UNIFORM, MCS_M);
+    ASSERT_EQ(enumerator.getNumberOfAtoms(), 0);
+    ASSERT(enumerator.hasNext());
+    ASSERT_EQ(enumerator.next().getNumberOfNodes(), 0);
+    ASSERT(!enumerator.hasNext());
+    AtomsTriangulationsEnumerator counter(g, NONE, UNIFORM, MCS_M);
+    ASSERT_EQ(counter.getNumberOfTriangulations(), 1LL);
+    return true;
+}
+
+bool TriangulationsTester::atomsrandom() const {
+    // Glued graphs have atoms with more triangulations than a round produces,
+    // so results are combined with results of earlier rounds
+    Graph cycle(6);
+    for (Node v=0; v<6; ++v) {
+        cycle.addEdge(v, (v+1)%6);
+    }
+    AtomsTriangulationsEnumerator cycles(glueOnEdge(cycle, cycle), NONE, UNIFORM, MCS_M);
+    set< vector< set<Node> > > cyclesTriangulations;
+    while (cycles.hasNext()) {
+        cyclesTriangulations.insert(asNeighborSets(cycles.next()));
+    }
+    ASSERT_EQ(cyclesTriangulations.size(), (unsigned)14*14);
+    auto gs = GraphProducer().add_random({6,8,10},{0.3,0.5}, true).get();
+    for (unsigned i=0; i<gs.size(); ++i) {
+        for (unsigned j=i; j<gs.size(); ++j) {
+            Graph g = glueOnEdge(gs[i].get_graph(), gs[j].get_graph());
+            set< vector< set<Node> > > plain = plainTriangulations(g);
+            AtomsTriangulationsEnumerator enumerator(g, NONE, UNIFORM, MCS_M);
+            set< vector< set<Node> > > triangulations;
+            unsigned count = 0;
+            while (enumerator.hasNext()) {
+                triangulations.insert(asNeighborSets(enumerator.next()));
+                ++count;
+            }
+            ASSERT_EQ(count, triangulations.size());
+            ASSERT(triangulations == plain);
+        }
+    }
+    return true;
+}
+
+// Adds to g a node adjacent to every node of each set, so it is simplicial if
+// the set is a clique
+static Graph addNodes(const Graph& g, const vector<NodeSet>& neighborhoods) {
+    int n = g.getNumberOfNodes();
+    Graph extended(n + neighborhoods.size());
+    for (Node v=0; v<n; ++v) {
+        for (Node u : g.getNeighbors(v)) {
+            if (v < u) {
+                extended.addEdge(v, u);
+            }
+        }
+    }
+    for (unsigned i=0; i<neighborhoods.size(); ++i) {
+        for (Node u : neighborhoods[i]) {
+            extended.addEdge(n+i, u);
+        }
+    }
+    return extended;
+}
+
+bool TriangulationsTester::reductionchordal() const {
+    // A 4-clique with a path 3-4-5 hanging from it
+    Graph g(6);
+    set<NodeSet> clique;
+    clique.insert(NodeSet({0,1,2,3}));
+    g.saturateNodeSets(clique);
+    g.addEdge(3,4);
+    g.addEdge(4,5);
+    GraphReduction reduction(make_shared<const Graph>(g));
+    ASSERT(reduction.isExact());
+    ASSERT_EQ(reduction.getNumberOfRemovedNodes(), 6);
+    ASSERT_EQ(reduction.getReducedGraph().getNumberOfNodes(), 0);
+    MinimalTriangulationsEnumerator enumerator(reduction.getReducedGraph(), NONE, UNIFORM, MCS_M);
+    vector<ChordalGraph> triangulations = enumerator.getAll();
+    ASSERT_EQ(triangulations.size(), (unsigned)1);
+    ASSERT(asNeighborSets(reduction.liftTriangulation(triangulations[0]))
+            == asNeighborSets(ChordalGraph(g)));
+    PMCEnumerator pmce(g);
+    ASSERT_EQ(reduction.liftPotentialMaximalCliques(NodeSetSet()), pmce.get());
+    return true;
+}
+
+bool TriangulationsTester::reductionsimplicial() const {
+    // Random graphs with simplicial nodes hanging from a node, an edge, and
+    // from each other
+    auto gs = GraphProducer().add_random({6,8,10},{0.3,0.5}, true).get();
+    for (unsigned i=0; i<gs.size(); ++i) {
+        const Graph& base = gs[i].get_graph();
+        int n = base.getNumberOfNodes();
+        vector<NodeSet> neighborhoods = {NodeSet({0}), NodeSet({n-1})};
+        for (Node u : base.getNeighbors(1)) {
+            neighborhoods.push_back(NodeSet({1, u}));
+            break;
+        }
+        Graph g = addNodes(addNodes(base, neighborhoods), {NodeSet({n})});
+        GraphReduction reduction(make_shared<const Graph>(g));
+        ASSERT(reduction.isExact());
+        ASSERT(reduction.getNumberOfRemovedNodes() >= (int)neighborhoods.size()+1);
+        PMCEnumerator reducedPMCs(reduction.getReducedGraph());
+        PMCEnumerator pmce(g);
+        ASSERT_EQ(reduction.liftPotentialMaximalCliques(reducedPMCs.get()), pmce.get());
+        set< vector< set<Node> > > lifted;
+        MinimalTriangulationsEnumerator enumerator(reduction.getReducedGraph(), NONE, UNIFORM, MCS_M);
+        while (enumerator.hasNext()) {
+            lifted.insert(asNeighborSets(reduction.liftTriangulation(enumerator.next())));
+        }
+        ASSERT(lifted == plainTriangulations(g));
+    }
+    return true;
+}
+
+bool TriangulationsTester::reductionwidth() const {
+    // In a cycle every node is almost simplicial with degree 2, the lower bound
+    Graph cycle(6);
+    for (Node v=0; v<6; ++v) {
+        cycle.addEdge(v, (v+1)%6);
+    }
+    GraphReduction cycleReduction(make_shared<const Graph>(cycle), WIDTH_RULES);
+    ASSERT(!cycleReduction.isExact());
+    ASSERT_EQ(cycleReduction.getWidthLowerBound(), 2);
+    ASSERT_EQ(cycleReduction.getReducedGraph().getNumberOfNodes(), 0);
+    ChordalGraph liftedCycle = cycleReduction.liftTriangulation(Graph(0));
+    ASSERT(plainTriangulations(liftedCycle) == set< vector< set<Node> > >({asNeighborSets(liftedCycle)}));
+    ASSERT_EQ(liftedCycle.getTreeWidth(), 2);
+    // The corners of a grid are almost simplicial. Eliminating nodes keeps the
+    // tree-width, so the best width lifted from the reduced graph is optimal.
+    vector<Graph> graphs;
+    Graph grid(9);
+    for (Node v=0; v<9; ++v) {
+        if (v%3 < 2) {
+            grid.addEdge(v, v+1);
+        }
+        if (v < 6) {
+            grid.addEdge(v, v+3);
+        }
+    }
+    graphs.push_back(grid);
+    for (auto gs : GraphProducer().add_random({8,10,12},{0.2,0.3}, true).get()) {
+        graphs.push_back(gs.get_graph());
+    }
+    for (const Graph& g : graphs) {
+        GraphReduction reduction(make_shared<const Graph>(g), WIDTH_RULES);
+        int bestWidth = g.getNumberOfNodes();
+        MinimalTriangulationsEnumerator enumerator(g, NONE, UNIFORM, MCS_M);
+        while (enumerator.hasNext()) {
+            bestWidth = min(bestWidth, enumerator.next().getTreeWidth());
+        }
+        ASSERT(reduction.getWidthLowerBound() <= bestWidth);
+        int bestLiftedWidth = g.getNumberOfNodes();
+        MinimalTriangulationsEnumerator reduced(reduction.getReducedGraph(), NONE, UNIFORM, MCS_M);
+        while (reduced.hasNext()) {
+            ChordalGraph lifted = reduction.liftTriangulation(reduced.next());
+            bestLiftedWidth = min(bestLiftedWidth, lifted.getTreeWidth());
+        }
+        ASSERT_EQ(bestLiftedWidth, bestWidth);
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,60 @@
+#ifndef TRIANGULATIONSTESTER_H_INCLUDED
+#define TRIANGULATIONSTESTER_H_INCLUDED
+
+#include "Graph.h"
+#include "TestInterface.h"
+
+#define TRIANGULATIONS_TEST_TABLE \
+    /* Minimal triangulations come out in the same order with more threads */ \
+    X(triangulationsthreadorder) \
+    /* Splitting the search into parts gives the same minimal triangulations */ \
+    X(partitionedtriangulations) \
+    /* Decomposition by clique minimal separators, and the triangulations \
+       found on the atoms */ \
+    X(atomstwocycles) \
+    X(atomschordal) \
+    X(atomsempty) \
+    X(atomsrandom) \
+    /* Reducing a graph and lifting the results back */ \
+    X(reductionchordal) \
+    X(reductionsimplicial) \
+    X(reductionwidth)
+
+typedef enum {
+#define X(func) TRIANGULATIONS_TEST_NAME__##func,
+    TRIANGULATIONS_TEST_TABLE
+#undef X
+    TRIANGULATIONS_TEST_NAME__LAST
+} TriangulationsTesterFunctions;
+
+namespace tdenum {
+
+class TriangulationsTester : public TestInterface {
+private:
+
+    // Calls all tests with flag_ values set to true.
+    TriangulationsTester& go();
+
+public:
+
+    // Define all functions and on/off flags.
+    #define X(_func) \
+        TriangulationsTester& set_##_func(); \
+        TriangulationsTester& unset__##_func(); \
+        TriangulationsTester& set_only_##_func(); \
+        bool _func() const; \
+        bool flag_##_func;
+    TRIANGULATIONS_TEST_TABLE
+    #undef X
+
+    // Calls all test functions, unless start=false.
+    TriangulationsTester();
+
+    // Sets / clears all flags
+    TriangulationsTester& set_all();
+    TriangulationsTester& clear_all();
+
+};
+
+}
+#endif // TRIANGULATIONSTESTER_H_INCLUDED
@@ -1,5 +1,7 @@
 #include "UtilsTester.h"
+#include "CancellationToken.h"
 #include <algorithm>
+#include <thread>
 using std::min;
 
 namespace tdenum {
@@ -528,4 +530,73 @@ bool UtilsTester::path_string_decomposition() const {
     return true;
 }
 
+
+bool UtilsTester::cancellation_cancel() const {
+    CancellationToken token;
+    ASSERT(!token.isCancelled());
+    ASSERT(!token.poll());
+    token.cancel();
+    ASSERT(token.isCancelled());
+    // A cancelled token is seen by the next poll
+    ASSERT(token.poll());
+    return true;
+}
+
+bool UtilsTester::cancellation_deadline() const {
+    CancellationToken token;
+    token.setTimeLimit(0);
+    token.unsetTimeLimit();
+    ASSERT(!token.isCancelled());
+    token.setTimeLimit(0.2);
+    ASSERT(!token.isCancelled());
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    ASSERT(token.getElapsedSeconds() >= 0.3);
+    ASSERT(token.isCancelled());
+    // It stays cancelled
+    token.unsetTimeLimit();
+    ASSERT(token.isCancelled());
+    return true;
+}
+
+bool UtilsTester::cancellation_parent() const {
+    CancellationTokenPtr parent = make_shared<CancellationToken>();
+    CancellationTokenPtr child = make_shared<CancellationToken>(parent);
+    CancellationTokenPtr grandchild = make_shared<CancellationToken>(child);
+    CancellationTokenPtr sibling = make_shared<CancellationToken>(parent);
+    // Cancelling a child leaves its parent and siblings running
+    child->cancel();
+    ASSERT(grandchild->isCancelled());
+    ASSERT(!parent->isCancelled());
+    ASSERT(!sibling->isCancelled());
+    parent->cancel();
+    ASSERT(sibling->isCancelled());
+    // The deadline of a parent cancels its children
+    CancellationTokenPtr limited = make_shared<CancellationToken>();
+    CancellationToken limitedChild(limited);
+    limited->setTimeLimit(0);
+    ASSERT(limitedChild.isCancelled());
+    return true;
+}
+
+bool UtilsTester::cancellation_poll() const {
+    // The clock is read once the count of the thread reaches the interval, and
+    // the count restarts then
+    CancellationToken first;
+    first.setTimeLimit(0);
+    int calls = 1;
+    while (!first.poll()) {
+        ++calls;
+    }
+    ASSERT(calls <= CANCELLATION_POLL_INTERVAL);
+    CancellationToken second;
+    second.setTimeLimit(0);
+    calls = 1;
+    while (!second.poll()) {
+        ++calls;
+    }
+    ASSERT_EQ(calls, CANCELLATION_POLL_INTERVAL);
+    ASSERT(second.poll());
+    return true;
+}
+
 }
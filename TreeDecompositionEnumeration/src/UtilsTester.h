@@ -29,7 +29,11 @@ namespace tdenum {
     X(push_back_unique) \
     X(vec_range) \
     X(set_union_intersection) \
-    X(path_string_decomposition)
+    X(path_string_decomposition) \
+    X(cancellation_cancel) \
+    X(cancellation_deadline) \
+    X(cancellation_parent) \
+    X(cancellation_poll)
 
 class UtilsTester : public TestInterface {
 private: